@@ -0,0 +1,274 @@
+// Microbenchmarks of hand evaluation, shuffling and dealing.
+//
+// Usage: poker-bench [filter] [max threads]
+//
+// Runs every benchmark whose name contains 'filter' on 1, 2, 4, ... threads
+// up to 'max threads' (all of the hardware threads by default), and reports
+// the time per operation on one thread and the operations per second over
+// all of them. Every thread works through the same inputs, so the numbers of
+// different evaluators and inputs can be compared with each other.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poker/batch_evaluator.hpp>
+#include <poker/card_set.hpp>
+#include <poker/dealer.hpp>
+#include <poker/deck.hpp>
+#include <poker/hand.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/state_table.hpp>
+#include "poker/detail/random.hpp"
+
+using namespace poker;
+
+namespace {
+
+constexpr auto num_inputs = std::size_t{1} << 16;
+
+using clock_type = std::chrono::steady_clock;
+
+// Runs a batch of operations. Returns how many it ran.
+using benchmark_pass = std::function<std::uint64_t()>;
+
+struct benchmark {
+    std::string name;
+    std::function<benchmark_pass()> make_pass; // Called once per thread.
+};
+
+// Keeps the results alive, so that the work is not optimized away.
+std::atomic<std::uint64_t> sink{0};
+
+auto to_cards(card_set cs) -> std::array<card, 7> {
+    auto result = std::array<card, 7>{};
+    std::copy(cs.begin(), cs.end(), result.begin());
+    return result;
+}
+
+auto random_card(detail::xoshiro256& g) -> card {
+    return to_card(static_cast<card_index>(detail::bounded(g, 52)));
+}
+
+// Fills 'cs' up to 7 cards at random.
+void fill(card_set& cs, detail::xoshiro256& g) {
+    while (cs.size() < 7) cs.insert(random_card(g));
+}
+
+auto random_hands() -> std::vector<card_set> {
+    auto g = detail::xoshiro256{1};
+    auto result = std::vector<card_set>(num_inputs);
+    for (auto& cs : result) fill(cs, g);
+    return result;
+}
+
+// Evenly spaced hands of the enumeration of every 7-card hand, in its order.
+auto enumerated_hands() -> std::vector<card_set> {
+    auto result = std::vector<card_set>{};
+    result.reserve(num_inputs);
+    constexpr auto stride = std::uint64_t{133784560} / num_inputs;
+    auto i = std::uint64_t{0};
+    auto c = std::array<int, 7>{0, 1, 2, 3, 4, 5, 6};
+    while (result.size() < num_inputs) {
+        if (i++ % stride == 0) {
+            auto cs = card_set{};
+            for (auto x : c) cs.insert(to_card(static_cast<card_index>(x)));
+            result.push_back(cs);
+        }
+        // Next combination in lexicographic order.
+        auto j = 6;
+        while (c[j] == 52 - 7 + j) --j;
+        ++c[j];
+        for (auto k = j + 1; k < 7; ++k) c[k] = c[k - 1] + 1;
+    }
+    return result;
+}
+
+// Hands with 5 to 7 cards of a suit, which take the flush lookup.
+auto flush_hands() -> std::vector<card_set> {
+    auto g = detail::xoshiro256{2};
+    auto result = std::vector<card_set>(num_inputs);
+    for (auto& cs : result) {
+        const auto suit = static_cast<card_suit>(detail::bounded(g, 4));
+        const auto num_suited = 5 + static_cast<int>(detail::bounded(g, 3));
+        while (cs.size() < num_suited) cs.insert(card{static_cast<card_rank>(detail::bounded(g, 13)), suit});
+        fill(cs, g);
+    }
+    return result;
+}
+
+// Hands holding a straight but no flush, which the card-by-card evaluator
+// has to search for.
+auto straight_hands() -> std::vector<card_set> {
+    auto g = detail::xoshiro256{3};
+    auto result = std::vector<card_set>(num_inputs);
+    for (auto& cs : result) {
+        do {
+            cs = card_set{};
+            // The wheel starts at the ace.
+            const auto low = static_cast<int>(detail::bounded(g, 10)) + 12;
+            for (auto r = low; r < low + 5; ++r) {
+                cs.insert(card{static_cast<card_rank>(r % 13), static_cast<card_suit>(detail::bounded(g, 4))});
+            }
+            fill(cs, g);
+        } while (evaluate_rank(cs).ranking() != hand_ranking::straight);
+    }
+    return result;
+}
+
+auto evaluator_benchmarks(const std::string& inputs_name, const std::vector<card_set>& inputs) -> std::vector<benchmark> {
+    auto result = std::vector<benchmark>{};
+    result.push_back({"hand/" + inputs_name, [&inputs] {
+        auto cards = std::vector<std::array<card, 7>>{};
+        for (auto cs : inputs) cards.push_back(to_cards(cs));
+        return benchmark_pass{[cards] () mutable {
+            auto x = 0;
+            for (auto& c : cards) x += hand{span<card, 7>{c}}.strength();
+            sink += static_cast<std::uint64_t>(x);
+            return std::uint64_t{cards.size()};
+        }};
+    }});
+    result.push_back({"evaluate_rank/" + inputs_name, [&inputs] {
+        return benchmark_pass{[&inputs] {
+            auto x = 0u;
+            for (auto cs : inputs) x += evaluate_rank(cs).value();
+            sink += x;
+            return std::uint64_t{inputs.size()};
+        }};
+    }});
+    result.push_back({"evaluate_batch/" + inputs_name, [&inputs] {
+        return benchmark_pass{[&inputs, ranks = std::vector<hand_rank>(inputs.size())] () mutable {
+            evaluate_batch(inputs, ranks);
+            sink += ranks.back().value();
+            return std::uint64_t{inputs.size()};
+        }};
+    }});
+    result.push_back({"state_table/" + inputs_name, [&inputs] {
+        static const auto table = state_table{};
+        auto cards = std::vector<std::array<card, 7>>{};
+        for (auto cs : inputs) cards.push_back(to_cards(cs));
+        return benchmark_pass{[cards] {
+            auto x = 0u;
+            for (auto& c : cards) {
+                auto state = table.start();
+                for (auto card : c) state = table.advance(state, card);
+                x += table.rank(state).value();
+            }
+            sink += x;
+            return std::uint64_t{cards.size()};
+        }};
+    }});
+    return result;
+}
+
+auto other_benchmarks() -> std::vector<benchmark> {
+    auto result = std::vector<benchmark>{};
+    // Shuffling the deck and dealing 9 players and the board, as a table does.
+    result.push_back({"deck/shuffle_and_deal", [] {
+        return benchmark_pass{[g = detail::xoshiro256{4}, d = deck{}] () mutable {
+            auto x = 0;
+            for (auto i = 0; i < 1024; ++i) {
+                d.fill_and_shuffle_first(g, 23);
+                for (auto j = 0; j < 23; ++j) x += static_cast<int>(d.draw().rank);
+            }
+            sink += static_cast<std::uint64_t>(x);
+            return std::uint64_t{1024};
+        }};
+    }});
+    // A whole hand of 6 players checking and calling down to the showdown.
+    result.push_back({"dealer/hand", [] {
+        return benchmark_pass{[g = detail::xoshiro256{5}] () mutable {
+            for (auto i = 0; i < 256; ++i) {
+                auto players = seat_array{};
+                for (auto seat = 0; seat < 6; ++seat) players.add_player(seat, player{1000});
+                auto d = deck{g};
+                auto cc = community_cards{};
+                auto dlr = dealer{players, 0, forced_bets{blinds{5, 10}}, d, cc};
+                dlr.start_hand();
+                while (dlr.hand_in_progress() && !dlr.betting_rounds_completed()) {
+                    while (dlr.betting_round_in_progress()) {
+                        const auto check = dlr.legal_actions().contains(dealer::action::check);
+                        dlr.action_taken(check ? dealer::action::check : dealer::action::call);
+                    }
+                    dlr.end_betting_round();
+                }
+                if (dlr.hand_in_progress()) dlr.showdown();
+                sink += static_cast<std::uint64_t>(players[0].stack());
+            }
+            return std::uint64_t{256};
+        }};
+    }});
+    return result;
+}
+
+// Runs 'b' on 'num_threads' threads for about 'duration'. Returns the
+// seconds it took and the number of operations run.
+auto run(const benchmark& b, unsigned num_threads, std::chrono::milliseconds duration) -> std::pair<double, std::uint64_t> {
+    auto passes = std::vector<benchmark_pass>{};
+    for (auto t = 0u; t < num_threads; ++t) passes.push_back(b.make_pass());
+    // Warm the tables and the caches up.
+    for (auto& pass : passes) pass();
+
+    auto ready = std::atomic<unsigned>{0};
+    auto go = std::atomic<bool>{false};
+    auto stop = std::atomic<bool>{false};
+    auto total = std::atomic<std::uint64_t>{0};
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0u; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            ++ready;
+            while (!go) std::this_thread::yield();
+            auto ops = std::uint64_t{0};
+            while (!stop) ops += passes[t]();
+            total += ops;
+        });
+    }
+    while (ready != num_threads) std::this_thread::yield();
+    const auto start = clock_type::now();
+    go = true;
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    const auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return {seconds, total.load()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto filter = std::string{argc > 1 ? argv[1] : ""};
+    const auto max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::max(1u, std::thread::hardware_concurrency());
+
+    const auto random = random_hands();
+    const auto enumerated = enumerated_hands();
+    const auto flushes = flush_hands();
+    const auto straights = straight_hands();
+    auto benchmarks = std::vector<benchmark>{};
+    for (auto& b : evaluator_benchmarks("random", random))         benchmarks.push_back(std::move(b));
+    for (auto& b : evaluator_benchmarks("enumerated", enumerated)) benchmarks.push_back(std::move(b));
+    for (auto& b : evaluator_benchmarks("flush", flushes))         benchmarks.push_back(std::move(b));
+    for (auto& b : evaluator_benchmarks("straight", straights))    benchmarks.push_back(std::move(b));
+    for (auto& b : other_benchmarks())                             benchmarks.push_back(std::move(b));
+
+    auto thread_counts = std::vector<unsigned>{};
+    for (auto n = 1u; n < max_threads; n *= 2) thread_counts.push_back(n);
+    thread_counts.push_back(max_threads);
+
+    std::printf("%-28s %8s %12s %14s\n", "benchmark", "threads", "ns/op", "ops/s");
+    for (const auto& b : benchmarks) {
+        if (b.name.find(filter) == std::string::npos) continue;
+        for (auto num_threads : thread_counts) {
+            const auto [seconds, ops] = run(b, num_threads, std::chrono::milliseconds{300});
+            std::printf("%-28s %8u %12.2f %14.4g\n", b.name.c_str(), num_threads, seconds * 1e9 * num_threads / ops, ops / seconds);
+            std::fflush(stdout);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <poker/card_set.hpp>
+#include <poker/hand_rank.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/span.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define POKER_DETAIL_HAS_AVX2_KERNEL 1
+#   include <immintrin.h>
+#else
+#   define POKER_DETAIL_HAS_AVX2_KERNEL 0
+#endif
+
+namespace poker::detail {
+
+inline void evaluate_batch_scalar(const card_set* in, hand_rank* out, std::size_t n) noexcept {
+    for (auto i = std::size_t{0}; i < n; ++i) {
+        out[i] = hand_rank{evaluate_7(in[i])};
+    }
+}
+
+#if POKER_DETAIL_HAS_AVX2_KERNEL
+
+// Evaluates 8 hands per iteration. A flush and a full house or four of a kind
+// never come out of the same 7 cards, so the best flush of any suit (the flush
+// table holds 0 for masks of fewer than 5 ranks) and the unsuited value can be
+// combined with a plain maximum instead of a branch.
+__attribute__((target("avx2")))
+inline void evaluate_batch_avx2(const card_set* in, hand_rank* out, std::size_t n) noexcept {
+    static_assert(sizeof(card_set) == 8 && sizeof(hand_rank) == 2);
+    const auto& tables = evaluator_tables::get();
+    const auto flush = reinterpret_cast<const int*>(tables.flush_data());
+    const auto mask_keys = reinterpret_cast<const int*>(tables.rank_key_data());
+    const auto displacements = reinterpret_cast<const int*>(tables.unsuited_7().displacements());
+    const auto values = reinterpret_cast<const int*>(tables.unsuited_7().values());
+
+    const auto suit_bits = _mm256_set1_epi64x(card_set::suit_bits);
+    const auto low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const auto high_dwords = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+    const auto low_mask = _mm256_set1_epi32(displaced_table::low_mask);
+    const auto value_mask = _mm256_set1_epi32(0xffff);
+
+    auto i = std::size_t{0};
+    for (; i + 8 <= n; i += 8) {
+        const auto first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 4));
+        auto rank_key = _mm256_setzero_si256();
+        auto flush_value = _mm256_setzero_si256();
+        for (auto suit = 0; suit < 4; ++suit) {
+            const auto x = _mm256_and_si256(_mm256_srli_epi64(first, 16 * suit), suit_bits);
+            const auto y = _mm256_and_si256(_mm256_srli_epi64(second, 16 * suit), suit_bits);
+            const auto mask = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, low_dwords),
+                                                 _mm256_permutevar8x32_epi32(y, high_dwords), 0xf0);
+            rank_key = _mm256_add_epi32(rank_key, _mm256_i32gather_epi32(mask_keys, mask, 4));
+            const auto suited = _mm256_and_si256(_mm256_i32gather_epi32(flush, mask, 2), value_mask);
+            flush_value = _mm256_max_epi32(flush_value, suited);
+        }
+        const auto displacement = _mm256_i32gather_epi32(displacements, _mm256_srli_epi32(rank_key, displaced_table::shift), 4);
+        const auto slot = _mm256_add_epi32(_mm256_and_si256(rank_key, low_mask), displacement);
+        const auto unsuited = _mm256_and_si256(_mm256_i32gather_epi32(values, slot, 2), value_mask);
+        const auto result = _mm256_max_epi32(flush_value, unsuited);
+        const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(packed));
+    }
+    evaluate_batch_scalar(in + i, out + i, n - i);
+}
+
+inline auto cpu_supports_avx2() noexcept -> bool {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+using evaluate_batch_kernel = void (*)(const card_set*, hand_rank*, std::size_t) noexcept;
+
+inline auto select_evaluate_batch_kernel() noexcept -> evaluate_batch_kernel {
+#if POKER_DETAIL_HAS_AVX2_KERNEL
+    if (cpu_supports_avx2()) return evaluate_batch_avx2;
+#endif
+    return evaluate_batch_scalar;
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// Evaluates many independent 7-card hands at once. The kernel is picked on
+// first use depending on what the CPU supports; every kernel produces the
+// same ranks as evaluate_rank().
+inline void evaluate_batch(span<const card_set> in, span<hand_rank> out) POKER_NOEXCEPT {
+    POKER_DETAIL_ASSERT(in.size() == out.size(), "Every hand must have a rank to be written to");
+    static const auto kernel = detail::select_evaluate_batch_kernel();
+    kernel(in.data(), out.data(), in.size());
+}
+
+} // namespace poker
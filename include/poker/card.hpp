@@ -1,13 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <tuple>
 
 #include "poker/detail/span.hpp"
 
 namespace poker {
 
-enum class card_rank { _2, _3, _4, _5, _6, _7, _8, _9, T, J, Q, K, A };
-enum class card_suit { clubs, diamonds, hearts, spades };
+enum class card_rank : unsigned char { _2, _3, _4, _5, _6, _7, _8, _9, T, J, Q, K, A };
+enum class card_suit : unsigned char { clubs, diamonds, hearts, spades };
 
 struct card {
     card_rank rank;
@@ -21,5 +22,18 @@ constexpr auto operator>  ( card lhs, card rhs ) noexcept -> bool { return rhs <
 constexpr auto operator<= ( card lhs, card rhs ) noexcept -> bool { return !(rhs < lhs);                                                }
 constexpr auto operator>= ( card lhs, card rhs ) noexcept -> bool { return !(lhs < rhs);                                                }
 
+// A card packed into a single byte as 13 * suit + rank. Card indices compare
+// the same way the cards do.
+enum class card_index : std::uint8_t {};
+
+constexpr auto to_card_index(card c) noexcept -> card_index {
+    return static_cast<card_index>(13 * static_cast<int>(c.suit) + static_cast<int>(c.rank));
+}
+
+constexpr auto to_card(card_index i) noexcept -> card {
+    const auto value = static_cast<int>(i);
+    return card{static_cast<card_rank>(value % 13), static_cast<card_suit>(value / 13)};
+}
+
 } // namespace poker
 
@@ -0,0 +1,463 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/combinations.hpp>
+#include <poker/hand_indexer.hpp>
+#include <poker/hand_strength.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/mapped_file.hpp"
+#include "poker/detail/parallel.hpp"
+#include "poker/detail/random.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker {
+
+struct abstraction_options {
+    int num_buckets = 200;
+    int num_bins = 50;                   // Of the equity histograms.
+    int max_iterations = 100;            // Of k-means.
+    std::uint64_t seed = 0;
+    unsigned num_threads = 0;            // All of the hardware threads if 0.
+    const char* checkpoint_path = nullptr;
+};
+
+} // namespace poker
+
+namespace poker::detail {
+
+// Adds to 'bins' how the hand strength of the hand on the river is spread
+// over the boards 'board' can still turn into.
+// EXPECTS: 'board' holds 0 or 3 to 5 cards, none of them in 'hole'.
+inline void add_equity_histogram(card_set hole, card_set board, span<float> bins) noexcept {
+    const auto num_bins = static_cast<int>(bins.size());
+    card_combinations{~(hole | board), 5 - board.size()}.for_each([&] (card_set cards) {
+        const auto strength = strength_of(opponent_hands{hole, board | cards}.totals(), 1);
+        ++bins[std::min(static_cast<int>(strength * num_bins), num_bins - 1)];
+    });
+}
+
+inline auto distance(const float* x, const float* y, int n) noexcept -> float {
+    auto sum = 0.0f;
+    for (auto i = 0; i < n; ++i) sum += (x[i] - y[i]) * (x[i] - y[i]);
+    return std::sqrt(sum);
+}
+
+// Centroid sums in fixed point, so that the order of the additions, and with
+// it the number of threads, does not change the result.
+struct alignas(64) cluster_sums {
+    std::vector<std::int64_t> sums;
+    std::vector<std::uint64_t> counts;
+};
+
+constexpr auto cluster_sum_scale = 16777216.0; // 2^24
+
+// The working state of a build: the features of every class, whether each
+// chunk of them is done, and the centroids of the clusters so far. It lives in
+// the checkpoint file if there is one, so a build that is cut short picks up
+// where it left off.
+class abstraction_workspace {
+public:
+    static constexpr auto chunk_size = std::uint64_t{4096};
+
+    // Returns std::nullopt if the checkpoint file cannot be opened or created.
+    // A checkpoint of another build is started over.
+    static auto open(std::uint64_t num_classes, const abstraction_options& options) -> std::optional<abstraction_workspace>;
+
+    auto num_chunks() const noexcept -> std::uint64_t { return (_num_classes + chunk_size - 1) / chunk_size; }
+
+    auto chunk_done(std::uint64_t chunk) const noexcept -> bool { return _done[chunk] != 0; }
+    void set_chunk_done(std::uint64_t chunk) noexcept { _done[chunk] = 1; }
+
+    auto features(std::uint64_t index) const noexcept -> float* { return _features + index * _num_bins; }
+    auto centroids() const noexcept -> float* { return _centroids; }
+
+    // The number of k-means iterations the centroids are the result of, or -1
+    // if there are none yet.
+    auto iterations() const noexcept -> int { return static_cast<int>(_header[9]) - 1; }
+
+    void set_iterations(int iterations) noexcept {
+        _header[9] = static_cast<std::uint32_t>(iterations + 1);
+        if (_file) _file->flush();
+    }
+
+private:
+    static constexpr auto magic = std::uint32_t{0x43414b50}; // "PKAC"
+    static constexpr auto version = std::uint32_t{1};
+    static constexpr auto header_size = std::size_t{16}; // Words.
+
+    abstraction_workspace() = default;
+
+    // Without a checkpoint file.
+    std::vector<std::uint32_t> _header_image;
+    std::vector<unsigned char> _done_image;
+    std::vector<float> _feature_image;
+    std::optional<writable_mapped_file> _file;
+    std::uint64_t _num_classes = 0;
+    int _num_bins = 0;
+    std::uint32_t* _header = nullptr;
+    unsigned char* _done = nullptr;
+    float* _features = nullptr;
+    float* _centroids = nullptr;
+};
+
+inline auto abstraction_workspace::open(std::uint64_t num_classes, const abstraction_options& options)
+    -> std::optional<abstraction_workspace>
+{
+    auto result = abstraction_workspace{};
+    result._num_classes = num_classes;
+    result._num_bins = options.num_bins;
+    const auto done_words = (result.num_chunks() + 3) / 4;
+    const auto num_features = (num_classes + options.num_buckets) * options.num_bins;
+    const auto num_words = header_size + done_words + num_features;
+    const std::uint32_t header[] = {
+        magic, version, static_cast<std::uint32_t>(options.num_bins), static_cast<std::uint32_t>(options.num_buckets),
+        static_cast<std::uint32_t>(num_classes), static_cast<std::uint32_t>(num_classes >> 32),
+        static_cast<std::uint32_t>(options.seed), static_cast<std::uint32_t>(options.seed >> 32),
+    };
+    if (options.checkpoint_path == nullptr) {
+        result._header_image.resize(header_size);
+        result._done_image.resize(result.num_chunks());
+        result._feature_image.resize(num_features);
+        result._header = result._header_image.data();
+        result._done = result._done_image.data();
+        result._features = result._feature_image.data();
+    } else {
+        result._file = writable_mapped_file::open(options.checkpoint_path, num_words * 4);
+        if (!result._file) return std::nullopt;
+        const auto data = result._file->data();
+        if (std::memcmp(data, header, sizeof(header)) != 0) std::fill(data, data + num_words * 4, 0);
+        result._header = reinterpret_cast<std::uint32_t*>(data);
+        result._done = data + header_size * 4;
+        result._features = reinterpret_cast<float*>(data + (header_size + done_words) * 4);
+    }
+    std::copy(std::begin(header), std::end(header), result._header);
+    result._centroids = result._features + num_classes * options.num_bins;
+    return result;
+}
+
+// Picks the first centroids by k-means++ among a sample of the features.
+inline void seed_centroids(const abstraction_workspace& workspace, std::uint64_t num_classes, const abstraction_options& options) {
+    const auto k = static_cast<std::uint64_t>(options.num_buckets);
+    const auto d = options.num_bins;
+    auto g = xoshiro256{options.seed};
+    const auto uniform = [&] { return static_cast<double>(g() >> 11) * 0x1p-53; };
+    auto sample = std::vector<std::uint64_t>{};
+    if (num_classes <= 64 * k) {
+        for (auto i = std::uint64_t{0}; i < num_classes; ++i) sample.push_back(i);
+    } else {
+        for (auto i = std::uint64_t{0}; i < 64 * k; ++i) sample.push_back(static_cast<std::uint64_t>(uniform() * num_classes));
+    }
+    const auto centroids = workspace.centroids();
+    const auto pick = [&] (std::uint64_t j, std::uint64_t i) {
+        std::copy(workspace.features(i), workspace.features(i) + d, centroids + j * d);
+    };
+    pick(0, sample[static_cast<std::size_t>(uniform() * sample.size())]);
+    auto nearest = std::vector<double>(sample.size(), std::numeric_limits<double>::infinity());
+    for (auto j = std::uint64_t{1}; j < k; ++j) {
+        auto total = 0.0;
+        for (auto s = std::size_t{0}; s < sample.size(); ++s) {
+            const auto x = static_cast<double>(distance(workspace.features(sample[s]), centroids + (j - 1) * d, d));
+            nearest[s] = std::min(nearest[s], x * x);
+            total += nearest[s];
+        }
+        // With fewer distinct features than clusters, the rest are repeats.
+        auto s = static_cast<std::size_t>(uniform() * sample.size());
+        if (total > 0) {
+            auto target = uniform() * total;
+            for (s = 0; s + 1 < sample.size() && target >= nearest[s]; ++s) target -= nearest[s];
+        }
+        pick(j, sample[s]);
+    }
+}
+
+// Lloyd's k-means, with Hamerly's bounds to skip the classes whose cluster
+// cannot have changed. Writes the cluster of every class to 'clusters'.
+inline void cluster(abstraction_workspace& workspace, std::uint64_t num_classes, const abstraction_options& options,
+                    std::uint16_t* clusters)
+{
+    const auto k = options.num_buckets;
+    const auto d = options.num_bins;
+    const auto num_threads = resolve_num_threads(options.num_threads);
+    const auto centroids = workspace.centroids();
+    if (workspace.iterations() < 0) {
+        seed_centroids(workspace, num_classes, options);
+        workspace.set_iterations(0);
+    }
+
+    // Distances to the nearest centroid and to the second nearest, give or
+    // take how far the centroids moved since.
+    auto upper = std::vector<float>(num_classes);
+    auto lower = std::vector<float>(num_classes);
+    auto moves = std::vector<float>(k);
+    auto half_gaps = std::vector<float>(k);
+    auto sums = std::vector<cluster_sums>(num_threads);
+    for (auto& s : sums) {
+        s.sums.resize(static_cast<std::size_t>(k) * d);
+        s.counts.resize(k);
+    }
+
+    const auto assign = [&] (bool full) {
+        for (auto& s : sums) {
+            std::fill(s.sums.begin(), s.sums.end(), 0);
+            std::fill(s.counts.begin(), s.counts.end(), 0);
+        }
+        // The biggest move, and the biggest but the one of its cluster.
+        auto max_move = 0.0f, second_move = 0.0f;
+        auto max_cluster = -1;
+        for (auto j = 0; j < k; ++j) {
+            if (moves[j] > max_move) {
+                second_move = max_move;
+                max_move = moves[j];
+                max_cluster = j;
+            } else {
+                second_move = std::max(second_move, moves[j]);
+            }
+        }
+        for (auto j = 0; j < k; ++j) {
+            half_gaps[j] = std::numeric_limits<float>::infinity();
+            for (auto m = 0; m < k; ++m) {
+                if (m != j) half_gaps[j] = std::min(half_gaps[j], distance(centroids + j * d, centroids + m * d, d) / 2);
+            }
+        }
+        auto num_changed = std::atomic<std::uint64_t>{0};
+        parallel_for(workspace.num_chunks(), num_threads, [&] (std::size_t chunk, unsigned worker) {
+            auto& s = sums[worker];
+            auto changed = std::uint64_t{0};
+            const auto begin = chunk * abstraction_workspace::chunk_size;
+            const auto end = std::min(begin + abstraction_workspace::chunk_size, num_classes);
+            for (auto i = begin; i < end; ++i) {
+                const auto x = workspace.features(i);
+                auto a = static_cast<int>(clusters[i]);
+                auto bound = 0.0f;
+                if (!full) {
+                    upper[i] += moves[a];
+                    lower[i] -= a == max_cluster ? second_move : max_move;
+                    bound = std::max(half_gaps[a], lower[i]);
+                    if (upper[i] > bound) upper[i] = distance(x, centroids + a * d, d);
+                }
+                if (full || upper[i] > bound) {
+                    auto best = std::numeric_limits<float>::infinity();
+                    auto second = std::numeric_limits<float>::infinity();
+                    auto nearest = 0;
+                    for (auto j = 0; j < k; ++j) {
+                        const auto dist = distance(x, centroids + j * d, d);
+                        if (dist < best) {
+                            second = best;
+                            best = dist;
+                            nearest = j;
+                        } else if (dist < second) {
+                            second = dist;
+                        }
+                    }
+                    changed += nearest != a;
+                    a = nearest;
+                    clusters[i] = static_cast<std::uint16_t>(a);
+                    upper[i] = best;
+                    lower[i] = second;
+                }
+                ++s.counts[a];
+                for (auto b = 0; b < d; ++b) s.sums[a * d + b] += std::llround(x[b] * cluster_sum_scale);
+            }
+            num_changed += changed;
+        });
+        return num_changed.load();
+    };
+
+    auto changed = assign(true);
+    for (auto iteration = workspace.iterations(); iteration < options.max_iterations && changed != 0; ++iteration) {
+        for (auto j = 0; j < k; ++j) {
+            auto count = std::uint64_t{0};
+            for (const auto& s : sums) count += s.counts[j];
+            moves[j] = 0;
+            // An empty cluster keeps its centroid.
+            if (count == 0) continue;
+            auto moved = 0.0;
+            for (auto b = 0; b < d; ++b) {
+                auto sum = std::int64_t{0};
+                for (const auto& s : sums) sum += s.sums[j * d + b];
+                const auto c = static_cast<float>(sum / cluster_sum_scale / count);
+                moved += (c - centroids[j * d + b]) * (c - centroids[j * d + b]);
+                centroids[j * d + b] = c;
+            }
+            moves[j] = static_cast<float>(std::sqrt(moved));
+        }
+        workspace.set_iterations(iteration + 1);
+        changed = assign(false);
+    }
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// Buckets of the classes of deals of a round, for solvers to play in place of
+// the deals themselves. Hands are bucketed by how their equity is spread over
+// the boards to come, so that hands that are strong now are told from hands
+// that may get there.
+//
+// Building the buckets computes a histogram of equities for every class and
+// clusters them with k-means. Histograms are compared by their cumulative
+// sums, which tells apart hands whose equity is spread differently, much like
+// the earth mover's distance does. On many threads, the flop and the turn
+// take minutes to hours. A checkpoint file keeps the histograms computed so
+// far and the centroids of every iteration, so a build that is cut short and
+// run again with the same options picks up where it left off. The buckets are
+// saved to a flat file with 16 bits per class, and mapped back into memory.
+class card_abstraction {
+public:
+    card_abstraction(card_abstraction&&) = default;
+    auto operator=(card_abstraction&&) -> card_abstraction& = default;
+
+    // Buckets the classes of 'round' of hand_indexer::holdem() by the hand
+    // strength of the hands on the river. The river is left out: its
+    // histograms have a single bin, and its 2.4 billion classes would not fit
+    // in memory, so river hands are best bucketed by hand_strength() itself.
+    // Returns std::nullopt if the checkpoint file cannot be opened or created.
+    // EXPECTS: 0 <= round < 3, 1 <= options.num_buckets <= 65536,
+    //          options.num_bins >= 1
+    static auto build(int round, const abstraction_options& options = {}) -> std::optional<card_abstraction>;
+
+    // Buckets 'num_classes' classes by the histograms
+    // 'histogram_of(index, bins)' adds to 'bins', which are zeroed. The
+    // histograms are normalized.
+    template<class F>
+    static auto build(std::uint64_t num_classes, F histogram_of, const abstraction_options& options)
+        -> std::optional<card_abstraction>;
+
+    // Returns std::nullopt if the file cannot be read or does not hold buckets.
+    static auto load(const char* path) -> std::optional<card_abstraction>;
+
+    auto save(const char* path) const -> bool;
+
+    auto num_buckets() const noexcept -> int { return _num_buckets; }
+
+    auto size() const noexcept -> std::uint64_t { return _size; }
+
+    // EXPECTS: index < size()
+    auto bucket(std::uint64_t index) const POKER_NOEXCEPT -> int {
+        POKER_DETAIL_ASSERT(index < size(), "Invalid index");
+        return _buckets[index];
+    }
+
+private:
+    static constexpr auto magic = std::uint32_t{0x42434b50}; // "PKCB"
+    static constexpr auto version = std::uint32_t{1};
+    static constexpr auto header_size = std::size_t{32}; // Bytes.
+
+    card_abstraction() = default;
+
+    card_abstraction(detail::mapped_file file, int num_buckets, std::uint64_t size) noexcept;
+
+    // Padded to a whole number of 32-bit words.
+    static auto num_padded(std::uint64_t num_classes) noexcept -> std::size_t {
+        return static_cast<std::size_t>((num_classes + 1) / 2 * 2);
+    }
+
+    static auto file_size(std::uint64_t num_classes) noexcept -> std::size_t {
+        return header_size + num_padded(num_classes) * sizeof(std::uint16_t);
+    }
+
+    std::vector<std::uint16_t> _image; // The buckets of a built abstraction.
+    detail::mapped_file _file;
+    int _num_buckets = 0;
+    std::uint64_t _size = 0;
+    const std::uint16_t* _buckets = nullptr;
+};
+
+inline auto card_abstraction::build(int round, const abstraction_options& options) -> std::optional<card_abstraction> {
+    POKER_DETAIL_ASSERT(round >= 0 && round < 3, "Invalid round");
+    const auto indexer = hand_indexer::holdem();
+    const auto num_cards = static_cast<std::size_t>(indexer.num_cards(round));
+    return build(indexer.size(round), [&] (std::uint64_t index, span<float> bins) {
+        auto cards = std::array<card, 7>{};
+        indexer.unindex(round, index, span<card>(cards).first(num_cards));
+        auto hole = card_set{}, board = card_set{};
+        hole.insert(cards[0]);
+        hole.insert(cards[1]);
+        for (auto i = std::size_t{2}; i < num_cards; ++i) board.insert(cards[i]);
+        detail::add_equity_histogram(hole, board, bins);
+    }, options);
+}
+
+template<class F>
+inline auto card_abstraction::build(std::uint64_t num_classes, F histogram_of, const abstraction_options& options)
+    -> std::optional<card_abstraction>
+{
+    POKER_DETAIL_ASSERT(options.num_buckets >= 1 && options.num_buckets <= 65536, "Invalid number of buckets");
+    POKER_DETAIL_ASSERT(options.num_bins >= 1, "Invalid number of bins");
+    auto workspace = detail::abstraction_workspace::open(num_classes, options);
+    if (!workspace) return std::nullopt;
+
+    const auto d = static_cast<std::size_t>(options.num_bins);
+    detail::parallel_for(workspace->num_chunks(), options.num_threads, [&] (std::size_t chunk, unsigned) {
+        if (workspace->chunk_done(chunk)) return;
+        const auto begin = chunk * detail::abstraction_workspace::chunk_size;
+        const auto end = std::min(begin + detail::abstraction_workspace::chunk_size, num_classes);
+        for (auto i = begin; i < end; ++i) {
+            const auto features = workspace->features(i);
+            std::fill(features, features + d, 0.0f);
+            histogram_of(i, span<float>(features, d));
+            // Normalized cumulative sums.
+            auto total = 0.0f;
+            for (auto b = std::size_t{0}; b < d; ++b) total += features[b];
+            auto sum = 0.0f;
+            for (auto b = std::size_t{0}; b < d; ++b) {
+                sum += features[b];
+                features[b] = total > 0 ? sum / total : 0;
+            }
+        }
+        workspace->set_chunk_done(chunk);
+    });
+
+    auto result = card_abstraction{};
+    result._image.resize(num_padded(num_classes));
+    detail::cluster(*workspace, num_classes, options, result._image.data());
+    result._num_buckets = options.num_buckets;
+    result._size = num_classes;
+    result._buckets = result._image.data();
+    return result;
+}
+
+inline card_abstraction::card_abstraction(detail::mapped_file file, int num_buckets, std::uint64_t size) noexcept
+    : _file{std::move(file)}
+    , _num_buckets{num_buckets}
+    , _size{size}
+    , _buckets{reinterpret_cast<const std::uint16_t*>(_file.data() + header_size)}
+{
+}
+
+inline auto card_abstraction::load(const char* path) -> std::optional<card_abstraction> {
+    auto file = detail::mapped_file::open(path);
+    if (!file || file->size() < header_size) return std::nullopt;
+    std::uint32_t header[header_size / 4];
+    std::memcpy(header, file->data(), header_size);
+    const auto num_classes = header[3] | std::uint64_t{header[4]} << 32;
+    if (header[0] != magic || header[1] != version || file->size() != file_size(num_classes)) return std::nullopt;
+    return card_abstraction{std::move(*file), static_cast<int>(header[2]), num_classes};
+}
+
+inline auto card_abstraction::save(const char* path) const -> bool {
+    const std::uint32_t header[header_size / 4] = {
+        magic, version, static_cast<std::uint32_t>(_num_buckets),
+        static_cast<std::uint32_t>(_size), static_cast<std::uint32_t>(_size >> 32),
+    };
+    auto out = std::ofstream{path, std::ios::binary};
+    out.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(header_size));
+    out.write(reinterpret_cast<const char*>(_buckets), static_cast<std::streamsize>(num_padded(_size) * sizeof(std::uint16_t)));
+    return static_cast<bool>(out);
+}
+
+} // namespace poker
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+
+#include <poker/card.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker {
+
+// A set of cards as a 64-bit board. Each suit occupies 16 bits, of which the
+// low 13 hold one bit per rank, so the ranks of a suit can be read off with a
+// shift and a mask.
+class card_set {
+    std::uint64_t _bits = 0;
+
+    static constexpr auto bit(card c) noexcept -> std::uint64_t {
+        return std::uint64_t{1} << (16 * static_cast<int>(c.suit) + static_cast<int>(c.rank));
+    }
+
+public:
+    static constexpr auto suit_bits = std::uint64_t{0x1fff};
+    static constexpr auto all_bits  = std::uint64_t{0x1fff1fff1fff1fff};
+
+    class iterator {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = card;
+        using pointer = const card*;
+        using reference = card;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr iterator() noexcept = default;
+
+        constexpr explicit iterator(std::uint64_t bits) noexcept
+            : _bits{bits}
+        {
+        }
+
+        constexpr auto operator*() const noexcept -> card {
+            const auto i = detail::countr_zero(_bits);
+            return card{static_cast<card_rank>(i % 16), static_cast<card_suit>(i / 16)};
+        }
+
+        constexpr auto operator++() noexcept -> iterator& {
+            _bits &= _bits - 1;
+            return *this;
+        }
+
+        constexpr auto operator++(int) noexcept -> iterator {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr auto operator==(const iterator& other) const noexcept -> bool {
+            return _bits == other._bits;
+        }
+
+        constexpr auto operator!=(const iterator& other) const noexcept -> bool {
+            return _bits != other._bits;
+        }
+
+    private:
+        std::uint64_t _bits = 0;
+    };
+
+    constexpr card_set() noexcept = default;
+
+    explicit card_set(span<const card> cards) noexcept {
+        for (auto c : cards) insert(c);
+    }
+
+    static constexpr auto from_bits(std::uint64_t bits) noexcept -> card_set {
+        auto result = card_set{};
+        result._bits = bits & all_bits;
+        return result;
+    }
+
+    static constexpr auto full() noexcept -> card_set {
+        return from_bits(all_bits);
+    }
+
+    constexpr auto bits() const noexcept -> std::uint64_t {
+        return _bits;
+    }
+
+    constexpr auto size() const noexcept -> int {
+        return detail::popcount(_bits);
+    }
+
+    constexpr auto empty() const noexcept -> bool {
+        return _bits == 0;
+    }
+
+    constexpr auto contains(card c) const noexcept -> bool {
+        return (_bits & bit(c)) != 0;
+    }
+
+    constexpr auto contains(card_index i) const noexcept -> bool {
+        return contains(to_card(i));
+    }
+
+    constexpr void insert(card c) noexcept {
+        _bits |= bit(c);
+    }
+
+    constexpr void insert(card_index i) noexcept {
+        insert(to_card(i));
+    }
+
+    constexpr void erase(card c) noexcept {
+        _bits &= ~bit(c);
+    }
+
+    constexpr void erase(card_index i) noexcept {
+        erase(to_card(i));
+    }
+
+    // The 13-bit mask of the ranks held in the given suit.
+    constexpr auto suit_mask(card_suit suit) const noexcept -> unsigned {
+        return static_cast<unsigned>(_bits >> 16 * static_cast<int>(suit) & suit_bits);
+    }
+
+    // The 13-bit mask of the ranks held in any suit.
+    constexpr auto rank_mask() const noexcept -> unsigned {
+        return static_cast<unsigned>((_bits | _bits >> 16 | _bits >> 32 | _bits >> 48) & suit_bits);
+    }
+
+    constexpr auto begin() const noexcept -> iterator { return iterator{_bits}; }
+    constexpr auto end()   const noexcept -> iterator { return iterator{};      }
+
+    constexpr auto operator|=(card_set other) noexcept -> card_set& { _bits |= other._bits;  return *this; }
+    constexpr auto operator&=(card_set other) noexcept -> card_set& { _bits &= other._bits;  return *this; }
+    constexpr auto operator^=(card_set other) noexcept -> card_set& { _bits ^= other._bits;  return *this; }
+    constexpr auto operator-=(card_set other) noexcept -> card_set& { _bits &= ~other._bits; return *this; }
+
+    friend constexpr auto operator| (card_set x, card_set y) noexcept -> card_set { return x |= y;                      }
+    friend constexpr auto operator& (card_set x, card_set y) noexcept -> card_set { return x &= y;                      }
+    friend constexpr auto operator^ (card_set x, card_set y) noexcept -> card_set { return x ^= y;                      }
+    friend constexpr auto operator- (card_set x, card_set y) noexcept -> card_set { return x -= y;                      }
+    friend constexpr auto operator~ (card_set x)             noexcept -> card_set { return full() - x;                  }
+    friend constexpr auto operator==(card_set x, card_set y) noexcept -> bool     { return x._bits == y._bits;          }
+    friend constexpr auto operator!=(card_set x, card_set y) noexcept -> bool     { return !(x == y);                   }
+};
+
+} // namespace poker
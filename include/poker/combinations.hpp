@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <poker/card_set.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/error.hpp"
+
+namespace poker::detail {
+
+// binomials[n][k] is C(n, k).
+constexpr auto binomials = [] {
+    auto result = std::array<std::array<std::uint64_t, 53>, 53>{};
+    for (auto n = 0; n < 53; ++n) {
+        result[n][0] = 1;
+        for (auto k = 1; k <= n; ++k) result[n][k] = result[n - 1][k - 1] + result[n - 1][k];
+    }
+    return result;
+}();
+
+// The colex rank of the set of bits 'x' among the sets of as many bits.
+constexpr auto colex_rank(std::uint64_t x) noexcept -> std::uint64_t {
+    auto rank = std::uint64_t{0};
+    for (auto i = 1; x != 0; x &= x - 1, ++i) rank += binomials[countr_zero(x)][i];
+    return rank;
+}
+
+// The set of 'k' of the lowest 'n' bits with colex rank 'rank'.
+// EXPECTS: rank < binomials[n][k]
+constexpr auto colex_unrank(std::uint64_t rank, int n, int k) noexcept -> std::uint64_t {
+    auto x = std::uint64_t{0};
+    for (auto i = k; i > 0; --i) {
+        do --n; while (binomials[n][i] > rank);
+        rank -= binomials[n][i];
+        x |= std::uint64_t{1} << n;
+    }
+    return x;
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// The k-card subsets of a set of cards, numbered 0 to size() - 1 in colex
+// order. Any number can be turned into its subset and back, so the subsets can
+// be cut into ranges for threads, and a walk that stops can be picked up from
+// the number it got to. The subsets of the cards left in a deck, or of the
+// cards not on the board and in no hand, are:
+//
+//     card_combinations{d.cards(), 2}
+//     card_combinations{~(dead | card_set{cc.cards()}), 5 - cc.cards().size()}
+//
+// Subsets are walked with Gosper's hack on the cards numbered densely, which
+// are spread back out to the cards with one pdep where BMI2 is available,
+// and a lookup per card elsewhere.
+class card_combinations {
+public:
+    // EXPECTS: 0 <= k <= cards.size()
+    card_combinations(card_set cards, int k) POKER_NOEXCEPT
+        : _cards{cards}
+        , _k{k}
+    {
+        POKER_DETAIL_ASSERT(k >= 0 && k <= cards.size(), "Cannot choose more cards than there are");
+#if !defined(__BMI2__)
+        auto i = 0;
+        for (auto bits = cards.bits(); bits != 0; bits &= bits - 1) _card_bits[i++] = bits & (~bits + 1);
+#endif
+    }
+
+    auto cards() const noexcept -> card_set { return _cards; }
+    auto k()     const noexcept -> int      { return _k;     }
+
+    auto size() const noexcept -> std::uint64_t {
+        return detail::binomials[_cards.size()][_k];
+    }
+
+    // EXPECTS: index < size()
+    auto unrank(std::uint64_t index) const POKER_NOEXCEPT -> card_set {
+        POKER_DETAIL_ASSERT(index < size(), "Invalid index");
+        return spread(detail::colex_unrank(index, _cards.size(), _k));
+    }
+
+    // EXPECTS: 'subset' is one of the subsets.
+    auto rank(card_set subset) const POKER_NOEXCEPT -> std::uint64_t {
+        POKER_DETAIL_ASSERT(subset.size() == _k && (subset - _cards).empty(), "Not a subset");
+        return detail::colex_rank(detail::extract_bits(subset.bits(), _cards.bits()));
+    }
+
+    // The subset numbered one higher.
+    // EXPECTS: 'subset' is one of the subsets, but not the last one.
+    auto next(card_set subset) const POKER_NOEXCEPT -> card_set {
+        POKER_DETAIL_ASSERT(_k != 0 && rank(subset) + 1 < size(), "There is no next subset");
+        return spread(dense_next(detail::extract_bits(subset.bits(), _cards.bits())));
+    }
+
+    // The numbers of range 'i' out of 'num_ranges' ranges that cut the
+    // subsets as evenly as can be, as [first, last).
+    // EXPECTS: i < num_ranges
+    auto range(std::uint64_t i, std::uint64_t num_ranges) const POKER_NOEXCEPT -> std::array<std::uint64_t, 2> {
+        POKER_DETAIL_ASSERT(i < num_ranges, "Invalid range");
+        const auto quotient = size() / num_ranges;
+        const auto remainder = size() % num_ranges;
+        const auto first = i * quotient + std::min(i, remainder);
+        return {first, first + quotient + (i < remainder)};
+    }
+
+    // Calls 'f(subset)' for the subsets numbered 'first' to 'last' - 1, in
+    // order.
+    // EXPECTS: first <= last <= size()
+    template<class F>
+    void for_each(std::uint64_t first, std::uint64_t last, F f) const {
+        POKER_DETAIL_ASSERT(first <= last && last <= size(), "Invalid range");
+        if (first == last) return;
+        auto x = detail::colex_unrank(first, _cards.size(), _k);
+        for (auto i = first; ; x = dense_next(x)) {
+            f(spread(x));
+            if (++i == last) break;
+        }
+    }
+
+    template<class F>
+    void for_each(F f) const {
+        for_each(0, size(), f);
+    }
+
+private:
+    // Gosper's hack.
+    static auto dense_next(std::uint64_t x) noexcept -> std::uint64_t {
+        const auto lowest = x & (~x + 1);
+        const auto ripple = x + lowest;
+        return ripple | ((x ^ ripple) >> 2 >> detail::countr_zero(lowest));
+    }
+
+    auto spread(std::uint64_t x) const noexcept -> card_set {
+#if defined(__BMI2__)
+        return card_set::from_bits(detail::deposit_bits(x, _cards.bits()));
+#else
+        // Only 'k' bits to move, so looking them up beats a bit at a time.
+        auto bits = std::uint64_t{0};
+        for (; x != 0; x &= x - 1) bits |= _card_bits[detail::countr_zero(x)];
+        return card_set::from_bits(bits);
+#endif
+    }
+
+    card_set _cards;
+    int _k;
+#if !defined(__BMI2__)
+    std::array<std::uint64_t, 52> _card_bits = {}; // By dense number.
+#endif
+};
+
+} // namespace poker
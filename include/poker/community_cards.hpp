@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 
 #include <poker/card.hpp>
 #include <poker/deck.hpp>
@@ -28,7 +29,7 @@ constexpr auto next(round_of_betting rob) noexcept -> round_of_betting {
 
 class community_cards {
     std::array<card, 5> _cards;
-    std::size_t _size = {0};
+    std::uint8_t _size = {0};
 
 public:
     community_cards() noexcept = default;
@@ -38,7 +39,7 @@ public:
     }
 
     void deal(span<const card> cards) POKER_NOEXCEPT {
-        POKER_DETAIL_ASSERT(static_cast<std::size_t>(cards.size()) <= 5 - _size, "Cannot deal more than there is undealt cards");
+        POKER_DETAIL_ASSERT(static_cast<std::size_t>(cards.size()) <= 5 - std::size_t{_size}, "Cannot deal more than there is undealt cards");
         for (auto c : cards) _cards[_size++] = c;
     }
 };
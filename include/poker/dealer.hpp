@@ -9,6 +9,7 @@
 #include <poker/community_cards.hpp>
 #include <poker/deck.hpp>
 #include <poker/hand.hpp>
+#include <poker/hand_rank.hpp>
 #include <poker/player.hpp>
 #include <poker/pot.hpp>
 #include <poker/slot_array.hpp>
@@ -116,9 +117,12 @@ public:
     void action_taken(action, chips bet = 0)   POKER_NOEXCEPT;
     void end_betting_round()                   POKER_NOEXCEPT;
     void showdown()                            POKER_NOEXCEPT;
+    template<class RankOf> void showdown(RankOf) POKER_NOEXCEPT;
+    template<class HighOf, class LowOf> void showdown(HighOf, LowOf) POKER_NOEXCEPT;
 
 private:
     auto next_or_wrap(seat_index) noexcept -> seat_index;
+    auto end_uncontested_showdown() POKER_NOEXCEPT -> bool;
     void collect_ante() noexcept;
     auto post_blinds() noexcept -> seat_index;
     void deal_hole_cards() noexcept;
@@ -312,6 +316,27 @@ inline void dealer::end_betting_round() POKER_NOEXCEPT {
 }
 
 inline void dealer::showdown() POKER_NOEXCEPT {
+    showdown([&] (seat_index i) { return evaluate_rank(_hole_cards[i], *_community_cards); });
+}
+
+// Settles the pots with hands evaluated by 'rank_of', which maps a seat index
+// to the rank of the hand held in that seat. This lets variants dealing their
+// own hole cards, like Omaha, share the pot logic.
+template<class RankOf>
+inline void dealer::showdown(RankOf rank_of) POKER_NOEXCEPT {
+    if (!end_uncontested_showdown()) _pot_manager.award(_players, rank_of);
+}
+
+// Settles the pots of a high-low split game. Each pot is split between the
+// best high hands and the best low hands, see pot_manager::award().
+template<class HighOf, class LowOf>
+inline void dealer::showdown(HighOf high_of, LowOf low_of) POKER_NOEXCEPT {
+    if (!end_uncontested_showdown()) _pot_manager.award(_players, high_of, low_of);
+}
+
+// Ends the hand and, if only one player is left, gives them the pot. Returns
+// whether the pot was given out.
+inline auto dealer::end_uncontested_showdown() POKER_NOEXCEPT -> bool {
     POKER_DETAIL_ASSERT(_round_of_betting == round_of_betting::river, "Round of betting must be river");
     POKER_DETAIL_ASSERT(!betting_round_in_progress(), "Betting round must not be in progress");
     POKER_DETAIL_ASSERT(betting_rounds_completed(), "Betting rounds must be completed");
@@ -321,30 +346,11 @@ inline void dealer::showdown() POKER_NOEXCEPT {
         // No need to evaluate the hand. There is only one player.
         const auto index = _pot_manager.pots().front().eligible_players().front();
         _players[index].add_to_stack(_pot_manager.pots().front().size());
-        return;
+        return true;
 
         // TODO: Also, no reveals in this case. Reveals are only necessary when there is >=2 players.
     }
-    for (auto& p : _pot_manager.pots()) {
-        auto player_results = std::vector<std::pair<seat_index, hand>>{};
-        player_results.reserve(p.eligible_players().size());
-        std::transform(p.eligible_players().begin(), p.eligible_players().end(), std::back_inserter(player_results), [&] (seat_index i) {
-            /* return std::pair{i, hand{_players[i].hole_cards, *_community_cards}}; */
-            return std::pair{i, hand{_hole_cards[i], *_community_cards}};
-        });
-        std::sort(player_results.begin(), player_results.end(), [] (auto&& lhs, auto&& rhs) {
-            return lhs.second > rhs.second;
-        });
-        auto first_winner = player_results.begin();
-        auto last_winner = std::adjacent_find(player_results.begin(), player_results.end(), [] (auto&& lhs, auto&& rhs) {
-            return lhs.second != rhs.second;
-        });
-        if (last_winner != player_results.end()) ++last_winner;
-        const auto payout = p.size() / static_cast<chips>(std::distance(first_winner, last_winner));
-        std::for_each(first_winner, last_winner, [&] (auto&& winner) {
-            _players[winner.first].add_to_stack(payout);
-        });
-    }
+    return false;
 }
 
 inline auto dealer::next_or_wrap(seat_index seat) noexcept -> seat_index {
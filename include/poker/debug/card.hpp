@@ -5,6 +5,7 @@
 #include <string_view>
 
 #include <poker/card.hpp>
+#include <poker/hole_cards.hpp>
 
 namespace poker::debug {
 
@@ -42,6 +43,11 @@ inline auto make_cards(std::string_view str) noexcept -> std::array<card, N> {
     return cards;
 }
 
+inline auto make_hole_cards(std::string_view str) noexcept -> hole_cards {
+    const auto cards = make_cards<2>(str);
+    return hole_cards{cards[0], cards[1]};
+}
+
 inline auto operator<<(std::ostream& os, card_rank rank) -> std::ostream& {
     constexpr char rank_symbols[] = {
         '2', '3', '4', '5', '6', '7', '8', '9', 'T', 'J', 'Q', 'K', 'A'
@@ -1,56 +1,128 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <utility>
 
 #include <poker/card.hpp>
+#include <poker/card_set.hpp>
 #include "poker/detail/error.hpp"
-#include "poker/detail/utility.hpp"
+#include "poker/detail/random.hpp"
 
-namespace poker {
+namespace poker::detail {
+
+// Card indices enumerate the cards suit by suit, rank by rank.
+inline constexpr auto all_card_indices = [] {
+    auto cards = std::array<card_index, 52>{};
+    for (auto i = std::size_t{0}; i < cards.size(); ++i) cards[i] = static_cast<card_index>(i);
+    return cards;
+}();
 
-class deck {
-    std::array<card, 52> _cards;
-    std::size_t _size = {0};
+// A deck of the cards in 'Cards', shuffled one card at a time by the
+// Fisher-Yates shuffle: every step picks one of the cards left at random and
+// moves it to the end, where it is drawn from. Refilling the deck only takes
+// the cards back, so a hand pays for the cards it uses rather than for all of
+// them.
+//
+// A deck filled from a generator is shuffled with that generator, as far as
+// it is asked to, and draws those cards. A deck filled from a seed and a hand
+// number shuffles as it draws, with its own SplitMix64.
+template<const auto& Cards>
+class basic_deck {
+    static constexpr auto num_cards = static_cast<std::uint8_t>(Cards.size());
+
+    splitmix64 _g{0};
+    // Always some order of all of the cards, the ones left to draw first.
+    // The ones from '_unshuffled' up to '_size' are in random order.
+    std::array<card_index, Cards.size()> _cards = Cards;
+    std::uint8_t _size = {0};
+    std::uint8_t _unshuffled = {0};
+    bool _seeded = false;
 
 public:
-    deck() noexcept = default;
+    basic_deck() noexcept = default;
 
     template<class URBG>
-    deck(URBG&& g)
-        : _size{52}
-    {
-        using poker::detail::to_underlying;
-        constexpr auto first_suit = to_underlying(card_suit::clubs);
-        constexpr auto last_suit = to_underlying(card_suit::spades);
-        constexpr auto first_rank = to_underlying(card_rank::_2);
-        constexpr auto last_rank = to_underlying(card_rank::A);
-        auto i =  std::size_t{0};
-        for (auto suit = first_suit; suit <= last_suit; ++suit) {
-            for (auto rank = first_rank; rank <= last_rank; ++rank) {
-                const auto arank = static_cast<card_rank>(rank);
-                const auto asuit = static_cast<card_suit>(suit);
-                _cards[i] = card{arank, asuit};
-                ++i;
-            }
-        }
-        std::shuffle(begin(_cards), end(_cards), std::forward<URBG>(g));
+    basic_deck(URBG&& g) {
+        fill_and_shuffle(g);
+    }
+
+    // Deals hand number 'hand_id' of a simulation run from 'seed'. The same
+    // seed and number always deal the same cards, so any hand can be dealt
+    // again on its own, on whichever thread.
+    basic_deck(std::uint64_t seed, std::uint64_t hand_id) noexcept {
+        fill_and_shuffle(seed, hand_id);
     }
 
     template<class URBG>
-    void fill_and_shuffle(URBG&& g) noexcept {
-        _size = 52;
-        std::shuffle(begin(_cards), end(_cards), std::forward<URBG>(g));
+    void fill_and_shuffle(URBG&& g) {
+        fill_and_shuffle_first(g, num_cards);
     }
 
+    // Shuffles only the first 'n' cards to be drawn, which are all that can
+    // be drawn until the next refill.
+    // EXPECTS: n <= number of cards
+    template<class URBG>
+    void fill_and_shuffle_first(URBG&& g, std::size_t n) {
+        POKER_DETAIL_ASSERT(n <= num_cards, "Cannot shuffle more cards than there are");
+        _size = num_cards;
+        _seeded = false;
+        for (auto top = num_cards; top > num_cards - n; --top) {
+            std::swap(_cards[bounded(g, top)], _cards[top - 1u]);
+        }
+        _unshuffled = static_cast<std::uint8_t>(num_cards - n);
+    }
+
+    void fill_and_shuffle(std::uint64_t seed, std::uint64_t hand_id) noexcept {
+        // The same hand must start from the same order, whatever came before.
+        _cards = Cards;
+        _size = _unshuffled = num_cards;
+        _seeded = true;
+        _g = splitmix64{stream_seed(seed, hand_id)};
+    }
+
+    // EXPECTS: A card is left, and the deck was filled from a seed or the
+    //          card was shuffled.
     [[nodiscard]]
     auto draw() POKER_NOEXCEPT -> card {
         POKER_DETAIL_ASSERT(_size > 0, "Cannot draw from an empty deck");
-        return _cards[--_size];
+        if (_size > _unshuffled) return to_card(_cards[--_size]);
+        POKER_DETAIL_ASSERT(_seeded, "Cannot draw more cards than were shuffled");
+        return draw_at(bounded(_g, _size));
+    }
+
+    // Draws with 'g' one of the cards left.
+    template<class URBG>
+    [[nodiscard]]
+    auto draw(URBG&& g) -> card {
+        POKER_DETAIL_ASSERT(_size > 0, "Cannot draw from an empty deck");
+        return draw_at(bounded(g, _size));
     }
 
     auto size() const noexcept -> std::size_t {
         return _size;
     }
+
+    // The cards left to draw.
+    auto cards() const noexcept -> card_set {
+        auto result = card_set{};
+        for (auto i = 0; i < _size; ++i) result.insert(to_card(_cards[i]));
+        return result;
+    }
+
+private:
+    auto draw_at(std::uint32_t i) noexcept -> card {
+        std::swap(_cards[i], _cards[--_size]);
+        _unshuffled = std::min(_unshuffled, _size);
+        return to_card(_cards[_size]);
+    }
 };
 
+} // namespace poker::detail
+
+namespace poker {
+
+using deck = detail::basic_deck<detail::all_card_indices>;
+
 } // namespace poker
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__BMI2__)
+#   include <immintrin.h>
+#endif
+
+namespace poker::detail {
+
+constexpr auto popcount(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    auto count = 0;
+    for (; x != 0; x &= x - 1) ++count;
+    return count;
+#endif
+}
+
+// EXPECTS: x != 0
+constexpr auto countr_zero(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    auto count = 0;
+    for (; (x & 1) == 0; x >>= 1) ++count;
+    return count;
+#endif
+}
+
+// EXPECTS: x != 0
+// Returns the position of the highest set bit.
+constexpr auto bit_floor_index(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    auto index = 0;
+    while (x >>= 1) ++index;
+    return index;
+#endif
+}
+
+// Returns the lowest set bit, or 0.
+constexpr auto lowest_bit(unsigned x) noexcept -> unsigned {
+    return x & (~x + 1);
+}
+
+// Moves the low bits of 'x' to the set bits of 'mask', lowest first, like
+// the BMI2 pdep instruction.
+inline auto deposit_bits(std::uint64_t x, std::uint64_t mask) noexcept -> std::uint64_t {
+#if defined(__BMI2__)
+    return _pdep_u64(x, mask);
+#else
+    auto result = std::uint64_t{0};
+    for (auto bit = std::uint64_t{1}; mask != 0; mask &= mask - 1, bit <<= 1) {
+        if (x & bit) result |= mask & (~mask + 1);
+    }
+    return result;
+#endif
+}
+
+// Gathers the bits of 'x' at the set bits of 'mask' into the low bits, like
+// the BMI2 pext instruction.
+inline auto extract_bits(std::uint64_t x, std::uint64_t mask) noexcept -> std::uint64_t {
+#if defined(__BMI2__)
+    return _pext_u64(x, mask);
+#else
+    auto result = std::uint64_t{0};
+    for (auto bit = std::uint64_t{1}; mask != 0; mask &= mask - 1, bit <<= 1) {
+        if (x & mask & (~mask + 1)) result |= bit;
+    }
+    return result;
+#endif
+}
+
+} // namespace poker::detail
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/combinations.hpp>
+#include <poker/hand_ranking.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/span.hpp"
+#include "poker/detail/utility.hpp"
+
+// Table-driven hand evaluation.
+//
+// A hand value packs the hand ranking into the top 4 bits and an
+// order-preserving index of the hand within that ranking into the low 12 bits,
+// so comparing two values as integers compares the hands they stand for.
+//
+// Flushes are looked up by the 13-bit rank mask of the flush suit. Everything
+// else only depends on how many cards of each rank there are, so the rank
+// counts are summed into a key unique to the rank multiset and looked up in a
+// perfect hash table.
+
+namespace poker::detail {
+
+using hand_value = std::uint16_t;
+
+constexpr auto make_hand_value(hand_ranking ranking, int index) noexcept -> hand_value {
+    return static_cast<hand_value>(to_underlying(ranking) << 12 | index);
+}
+
+constexpr auto hand_value_ranking(hand_value value) noexcept -> hand_ranking {
+    return static_cast<hand_ranking>(value >> 12);
+}
+
+constexpr auto hand_value_index(hand_value value) noexcept -> int {
+    return value & 0xfff;
+}
+
+// EXPECTS: 0 <= n <= 13
+constexpr auto binomial(int n, int k) noexcept -> int {
+    return k < 0 || k > n ? 0 : static_cast<int>(binomials[n][k]);
+}
+
+// Index of the set of ranks in 'mask' among all sets of ranks of the same
+// size. Sets which compare greater as kickers get greater indices.
+constexpr auto colex_index(unsigned mask) noexcept -> int {
+    return static_cast<int>(colex_rank(mask));
+}
+
+// Keeps the 'n' highest ranks of 'mask'.
+constexpr auto highest_ranks(unsigned mask, int n) noexcept -> unsigned {
+    while (popcount(mask) > n) mask &= mask - 1;
+    return mask;
+}
+
+// Returns the rank of the highest card of the best straight in 'mask', or -1.
+constexpr auto straight_high_rank(unsigned mask) noexcept -> int {
+    for (auto high = 12; high >= 4; --high) {
+        if ((mask >> (high - 4) & 0x1f) == 0x1f) return high;
+    }
+    if ((mask & 0x100f) == 0x100f) return 3; // A-2-3-4-5
+    return -1;
+}
+
+// Returns the rank of the highest card of the best straight in a mask of
+// ranks, or -1. Lets variants with other straights reuse the evaluation.
+using straight_rule = int (*)(unsigned mask) noexcept;
+
+// EXPECTS: 'mask' has at least 5 ranks.
+constexpr auto flush_hand_value(unsigned mask, straight_rule straight = straight_high_rank) noexcept -> hand_value {
+    const auto high = straight(mask);
+    if (high == 12) {
+        return make_hand_value(hand_ranking::royal_flush, 0);
+    } else if (high >= 0) {
+        return make_hand_value(hand_ranking::straight_flush, high);
+    } else {
+        return make_hand_value(hand_ranking::flush, colex_index(highest_ranks(mask, 5)));
+    }
+}
+
+// EXPECTS: 'counts' holds at least 5 cards, no more than 4 of each rank.
+constexpr auto unsuited_hand_value(const std::array<int, 13>& counts, straight_rule straight = straight_high_rank) noexcept -> hand_value {
+    auto present = 0u, pairs = 0u, trips = 0u, quads = 0u;
+    for (auto r = 0; r < 13; ++r) {
+        if (counts[r] >= 1) present |= 1u << r;
+        if (counts[r] >= 2) pairs   |= 1u << r;
+        if (counts[r] >= 3) trips   |= 1u << r;
+        if (counts[r] >= 4) quads   |= 1u << r;
+    }
+    if (quads != 0) {
+        const auto q = bit_floor_index(quads);
+        const auto kicker = bit_floor_index(present & ~(1u << q));
+        return make_hand_value(hand_ranking::four_of_a_kind, q * 13 + kicker);
+    }
+    if (trips != 0) {
+        const auto t = bit_floor_index(trips);
+        if (const auto rest = pairs & ~(1u << t); rest != 0) {
+            return make_hand_value(hand_ranking::full_house, t * 13 + bit_floor_index(rest));
+        }
+    }
+    if (const auto high = straight(present); high >= 0) {
+        return make_hand_value(hand_ranking::straight, high);
+    }
+    if (trips != 0) {
+        const auto t = bit_floor_index(trips);
+        const auto kickers = highest_ranks(present & ~(1u << t), 2);
+        return make_hand_value(hand_ranking::three_of_a_kind, t * binomial(13, 2) + colex_index(kickers));
+    }
+    if (popcount(pairs) >= 2) {
+        const auto both = highest_ranks(pairs, 2);
+        const auto kicker = bit_floor_index(present & ~both);
+        return make_hand_value(hand_ranking::two_pair, colex_index(both) * 13 + kicker);
+    }
+    if (pairs != 0) {
+        const auto p = bit_floor_index(pairs);
+        const auto kickers = highest_ranks(present & ~(1u << p), 3);
+        return make_hand_value(hand_ranking::pair, p * binomial(13, 3) + colex_index(kickers));
+    }
+    return make_hand_value(hand_ranking::high_card, colex_index(highest_ranks(present, 5)));
+}
+
+// Additive rank keys: summing the keys of the ranks of any number of cards up
+// to 7 (no more than 4 of a rank) gives a different key for every rank
+// multiset of that size.
+inline constexpr std::uint32_t rank_keys[13] = {
+    0, 1, 5, 22, 98, 453, 2031, 8698, 22854, 83661, 262349, 636345, 1479181
+};
+
+// Sum of the rank keys of the cards counted in 'counts'.
+constexpr auto counts_key(const std::array<int, 13>& counts) noexcept -> std::uint32_t {
+    auto key = std::uint32_t{0};
+    for (auto r = 0; r < 13; ++r) key += static_cast<std::uint32_t>(counts[r]) * rank_keys[r];
+    return key;
+}
+
+// Calls 'f' with the rank counts of every multiset of 'num_cards' ranks, no
+// more than 4 of a rank and none lower than 'lowest_rank'.
+template<class F>
+inline void for_each_rank_multiset(int num_cards, F f, int lowest_rank = 0) {
+    auto counts = std::array<int, 13>{};
+    const auto fill = [&] (const auto& self, int r, int remaining) -> void {
+        if (r == 13) {
+            if (remaining == 0) f(static_cast<const std::array<int, 13>&>(counts));
+            return;
+        }
+        for (auto c = 0; c <= 4 && c <= remaining; ++c) {
+            counts[r] = c;
+            self(self, r + 1, remaining - c);
+        }
+        counts[r] = 0;
+    };
+    fill(fill, lowest_rank, num_cards);
+}
+
+// Maps a sparse set of keys to hand values with two loads: the high bits of a
+// key select a displacement which is added to its low bits to find the slot.
+// The displacements are chosen when the table is built so that no two keys
+// share a slot.
+class displaced_table {
+public:
+    static constexpr auto shift = 9;
+    static constexpr auto low_mask = (std::uint32_t{1} << shift) - 1;
+
+    displaced_table() = default;
+
+    explicit displaced_table(const std::vector<std::pair<std::uint32_t, hand_value>>& entries) {
+        auto max_key = std::uint32_t{0};
+        for (const auto& e : entries) max_key = std::max(max_key, e.first);
+        auto buckets = std::vector<std::vector<std::pair<std::uint32_t, hand_value>>>((max_key >> shift) + 1);
+        for (const auto& e : entries) buckets[e.first >> shift].push_back(e);
+        auto order = std::vector<std::size_t>(buckets.size());
+        for (auto i = std::size_t{0}; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&] (std::size_t x, std::size_t y) {
+            return buckets[x].size() > buckets[y].size();
+        });
+        _displacements.assign(buckets.size(), 0);
+        auto used = std::vector<bool>{};
+        auto first_free = std::uint32_t{0};
+        for (auto b : order) {
+            if (buckets[b].empty()) break;
+            auto lowest = low_mask;
+            for (const auto& e : buckets[b]) lowest = std::min(lowest, e.first & low_mask);
+            auto displacement = first_free > lowest ? first_free - lowest : 0;
+            const auto fits = [&] {
+                for (const auto& e : buckets[b]) {
+                    const auto slot = (e.first & low_mask) + displacement;
+                    if (slot < used.size() && used[slot]) return false;
+                }
+                return true;
+            };
+            // Give up on filling the holes after a few tries and append the
+            // bucket at the end instead, trading table size for build time.
+            for (auto tries = 0; !fits(); ++tries, ++displacement) {
+                if (tries == 64) {
+                    displacement = static_cast<std::uint32_t>(used.size()) - lowest;
+                    break;
+                }
+            }
+            _displacements[b] = displacement;
+            for (const auto& e : buckets[b]) {
+                const auto slot = (e.first & low_mask) + displacement;
+                if (slot >= used.size()) {
+                    used.resize(slot + 1);
+                    _values.resize(slot + 1);
+                }
+                used[slot] = true;
+                _values[slot] = e.second;
+            }
+            while (first_free < used.size() && used[first_free]) ++first_free;
+        }
+        // Vector gathers load 4 bytes at a time.
+        _values.push_back(0);
+    }
+
+    auto operator[](std::uint32_t key) const noexcept -> hand_value {
+        return _values[(key & low_mask) + _displacements[key >> shift]];
+    }
+
+    auto displacements() const noexcept -> const std::uint32_t* { return _displacements.data(); }
+    auto values()        const noexcept -> const hand_value*    { return _values.data();        }
+
+private:
+    std::vector<std::uint32_t> _displacements;
+    std::vector<hand_value> _values;
+};
+
+class evaluator_tables {
+public:
+    static auto get() noexcept -> const evaluator_tables& {
+        static const auto tables = evaluator_tables{};
+        return tables;
+    }
+
+    // EXPECTS: 'mask' has at least 5 ranks.
+    auto flush(unsigned mask) const noexcept -> hand_value {
+        return _flush[mask];
+    }
+
+    // EXPECTS: 'key' is the sum of the rank keys of 5, 6 or 7 cards
+    // respectively.
+    auto unsuited_5(std::uint32_t key) const noexcept -> hand_value { return _unsuited_5[key]; }
+    auto unsuited_6(std::uint32_t key) const noexcept -> hand_value { return _unsuited_6[key]; }
+    auto unsuited_7(std::uint32_t key) const noexcept -> hand_value { return _unsuited_7[key]; }
+
+    // Sum of the rank keys of the ranks in 'mask'.
+    auto rank_key(unsigned mask) const noexcept -> std::uint32_t {
+        return _rank_keys[mask];
+    }
+
+    // Raw tables for the vectorized evaluator. Entries of the flush table for
+    // masks of fewer than 5 ranks are 0.
+    auto flush_data()    const noexcept -> const hand_value*      { return _flush.data();     }
+    auto rank_key_data() const noexcept -> const std::uint32_t*   { return _rank_keys.data(); }
+    auto unsuited_7()    const noexcept -> const displaced_table& { return _unsuited_7;       }
+
+    // Inverse of colex_index() for sets of 2, 3 and 5 ranks.
+    auto colex_mask(int index, int size) const noexcept -> unsigned {
+        switch (size) {
+        case 2:  return _colex_masks_2[index];
+        case 3:  return _colex_masks_3[index];
+        default: return _colex_masks_5[index];
+        }
+    }
+
+private:
+    evaluator_tables() {
+        for (auto mask = 0u; mask < _rank_keys.size(); ++mask) {
+            const auto size = popcount(mask);
+            if (size >= 5) _flush[mask] = flush_hand_value(mask);
+            for (auto r = 0; r < 13; ++r) {
+                if (mask >> r & 1) _rank_keys[mask] += rank_keys[r];
+            }
+            const auto index = colex_index(mask);
+            if (size == 2) _colex_masks_2[index] = static_cast<std::uint16_t>(mask);
+            if (size == 3) _colex_masks_3[index] = static_cast<std::uint16_t>(mask);
+            if (size == 5) _colex_masks_5[index] = static_cast<std::uint16_t>(mask);
+        }
+        _unsuited_5 = make_unsuited_table(5);
+        _unsuited_6 = make_unsuited_table(6);
+        _unsuited_7 = make_unsuited_table(7);
+    }
+
+    static auto make_unsuited_table(int num_cards) -> displaced_table {
+        auto entries = std::vector<std::pair<std::uint32_t, hand_value>>{};
+        for_each_rank_multiset(num_cards, [&] (const auto& counts) {
+            entries.emplace_back(counts_key(counts), unsuited_hand_value(counts));
+        });
+        return displaced_table{entries};
+    }
+
+    std::array<hand_value, 8192 + 1> _flush = {}; // Padded for vector gathers.
+    std::array<std::uint32_t, 8192> _rank_keys = {};
+    displaced_table _unsuited_5;
+    displaced_table _unsuited_6;
+    displaced_table _unsuited_7;
+    std::array<std::uint16_t, binomial(13, 2)> _colex_masks_2 = {};
+    std::array<std::uint16_t, binomial(13, 3)> _colex_masks_3 = {};
+    std::array<std::uint16_t, binomial(13, 5)> _colex_masks_5 = {};
+};
+
+// Returns a mask with a bit set in the 16-bit lane of every suit holding at
+// least 5 of the cards.
+constexpr auto flush_suits(card_set cards) noexcept -> std::uint64_t {
+    // Count the cards of each suit in its own lane.
+    auto x = cards.bits();
+    x = x - (x >> 1 & 0x5555555555555555);
+    x = (x & 0x3333333333333333) + (x >> 2 & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    x = (x + (x >> 8)) & 0x00ff00ff00ff00ff;
+    return (x + 0x000b000b000b000b) & 0x0010001000100010;
+}
+
+// EXPECTS: 'flush' is the non-zero result of flush_suits(cards).
+constexpr auto flush_mask(card_set cards, std::uint64_t flush) noexcept -> unsigned {
+    return static_cast<unsigned>(cards.bits() >> (countr_zero(flush) & ~15) & card_set::suit_bits);
+}
+
+// Sum of the rank keys of the cards.
+inline auto rank_key(card_set cards) noexcept -> std::uint32_t {
+    const auto& tables = evaluator_tables::get();
+    return tables.rank_key(cards.suit_mask(card_suit::clubs)) + tables.rank_key(cards.suit_mask(card_suit::diamonds))
+         + tables.rank_key(cards.suit_mask(card_suit::hearts)) + tables.rank_key(cards.suit_mask(card_suit::spades));
+}
+
+// A flush cannot be made together with a full house or four of a kind out of
+// 7 cards or fewer, so a flush is always the best hand when there is one.
+
+// EXPECTS: 'cards' holds 5 cards.
+inline auto evaluate_5(card_set cards) noexcept -> hand_value {
+    const auto& tables = evaluator_tables::get();
+    if (const auto flush = flush_suits(cards); flush != 0) return tables.flush(flush_mask(cards, flush));
+    return tables.unsuited_5(rank_key(cards));
+}
+
+// EXPECTS: 'cards' holds 6 cards.
+inline auto evaluate_6(card_set cards) noexcept -> hand_value {
+    const auto& tables = evaluator_tables::get();
+    if (const auto flush = flush_suits(cards); flush != 0) return tables.flush(flush_mask(cards, flush));
+    return tables.unsuited_6(rank_key(cards));
+}
+
+// EXPECTS: 'cards' holds 7 cards.
+inline auto evaluate_7(card_set cards) noexcept -> hand_value {
+    const auto& tables = evaluator_tables::get();
+    if (const auto flush = flush_suits(cards); flush != 0) return tables.flush(flush_mask(cards, flush));
+    return tables.unsuited_7(rank_key(cards));
+}
+
+inline auto evaluate_7(span<const card, 7> cards) noexcept -> hand_value {
+    return evaluate_7(card_set{cards});
+}
+
+// Returns the ranks of the five cards making up the hand, in the order in
+// which hand::cards() lists them.
+inline auto hand_value_ranks(hand_value value) noexcept -> std::array<int, 5> {
+    const auto& tables = evaluator_tables::get();
+    const auto index = hand_value_index(value);
+    const auto descending = [] (unsigned mask, int* out) {
+        for (; mask != 0; mask &= ~(1u << bit_floor_index(mask))) *out++ = bit_floor_index(mask);
+    };
+    auto ranks = std::array<int, 5>{};
+    switch (hand_value_ranking(value)) {
+    case hand_ranking::high_card:
+    case hand_ranking::flush:
+        descending(tables.colex_mask(index, 5), ranks.data());
+        break;
+    case hand_ranking::pair:
+        ranks[0] = ranks[1] = index / binomial(13, 3);
+        descending(tables.colex_mask(index % binomial(13, 3), 3), ranks.data() + 2);
+        break;
+    case hand_ranking::two_pair:
+        descending(tables.colex_mask(index / 13, 2), ranks.data() + 1);
+        ranks = {ranks[1], ranks[1], ranks[2], ranks[2], index % 13};
+        break;
+    case hand_ranking::three_of_a_kind:
+        ranks[0] = ranks[1] = ranks[2] = index / binomial(13, 2);
+        descending(tables.colex_mask(index % binomial(13, 2), 2), ranks.data() + 3);
+        break;
+    case hand_ranking::straight:
+    case hand_ranking::straight_flush:
+    case hand_ranking::royal_flush: {
+        const auto high = hand_value_ranking(value) == hand_ranking::royal_flush ? 12 : index;
+        for (auto i = 0; i < 5; ++i) ranks[i] = high - i;
+        if (high == 3) ranks[4] = 12; // A-2-3-4-5
+        break;
+    }
+    case hand_ranking::full_house:
+        ranks = {index / 13, index / 13, index / 13, index % 13, index % 13};
+        break;
+    case hand_ranking::four_of_a_kind:
+        ranks = {index / 13, index / 13, index / 13, index / 13, index % 13};
+        break;
+    }
+    return ranks;
+}
+
+// Picks the five cards out of 'cards' which make up the hand with the given
+// value.
+inline auto hand_value_cards(hand_value value, card_set cards) noexcept -> std::array<card, 5> {
+    auto available = cards.bits();
+    const auto ranking = hand_value_ranking(value);
+    if (ranking == hand_ranking::flush || ranking == hand_ranking::straight_flush || ranking == hand_ranking::royal_flush) {
+        for (auto suit = 0; suit < 4; ++suit) {
+            const auto suited = available & card_set::suit_bits << 16 * suit;
+            if (popcount(suited) >= 5) available = suited;
+        }
+    }
+    auto result = std::array<card, 5>{};
+    const auto ranks = hand_value_ranks(value);
+    for (auto i = 0; i < 5; ++i) {
+        const auto bit = bit_floor_index(available & std::uint64_t{0x0001000100010001} << ranks[i]);
+        available &= ~(std::uint64_t{1} << bit);
+        result[i] = card{static_cast<card_rank>(ranks[i]), static_cast<card_suit>(bit / 16)};
+    }
+    return result;
+}
+
+} // namespace poker::detail
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define POKER_DETAIL_HAS_MMAP 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   define POKER_DETAIL_HAS_MMAP 0
+#endif
+
+namespace poker::detail {
+
+// The read-only contents of a file. The file is mapped into memory where the
+// platform allows it and read into a buffer otherwise.
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    mapped_file(const mapped_file&) = delete;
+    auto operator=(const mapped_file&) -> mapped_file& = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+        : _data{std::exchange(other._data, nullptr)}
+        , _size{std::exchange(other._size, 0)}
+        , _mapped{std::exchange(other._mapped, false)}
+        , _buffer{std::move(other._buffer)}
+    {
+    }
+
+    auto operator=(mapped_file&& other) noexcept -> mapped_file& {
+        auto tmp = std::move(other);
+        std::swap(_data, tmp._data);
+        std::swap(_size, tmp._size);
+        std::swap(_mapped, tmp._mapped);
+        std::swap(_buffer, tmp._buffer);
+        return *this;
+    }
+
+    ~mapped_file() {
+#if POKER_DETAIL_HAS_MMAP
+        if (_mapped) ::munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+    }
+
+    static auto open(const char* path) -> std::optional<mapped_file> {
+        auto result = mapped_file{};
+#if POKER_DETAIL_HAS_MMAP
+        const auto fd = ::open(path, O_RDONLY);
+        if (fd == -1) return std::nullopt;
+        struct stat info;
+        if (::fstat(fd, &info) == -1 || info.st_size == 0) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        const auto size = static_cast<std::size_t>(info.st_size);
+        const auto address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) return std::nullopt;
+        result._data = static_cast<const unsigned char*>(address);
+        result._size = size;
+        result._mapped = true;
+#else
+        auto in = std::ifstream{path, std::ios::binary};
+        if (!in) return std::nullopt;
+        result._buffer.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+        if (in.bad() || result._buffer.empty()) return std::nullopt;
+        result._data = result._buffer.data();
+        result._size = result._buffer.size();
+#endif
+        return result;
+    }
+
+    auto data() const noexcept -> const unsigned char* { return _data; }
+    auto size() const noexcept -> std::size_t          { return _size; }
+
+private:
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+    bool _mapped = false;
+    std::vector<unsigned char> _buffer;
+};
+
+// A file of a fixed size that is written in place, e.g. to checkpoint a long
+// computation. The file is mapped into memory where the platform allows it,
+// so whatever is written reaches the file even if the process is killed.
+// Elsewhere it is read into a buffer that flush() writes back.
+class writable_mapped_file {
+public:
+    writable_mapped_file() = default;
+
+    writable_mapped_file(const writable_mapped_file&) = delete;
+    auto operator=(const writable_mapped_file&) -> writable_mapped_file& = delete;
+
+    writable_mapped_file(writable_mapped_file&& other) noexcept
+        : _path{std::move(other._path)}
+        , _data{std::exchange(other._data, nullptr)}
+        , _size{std::exchange(other._size, 0)}
+        , _mapped{std::exchange(other._mapped, false)}
+        , _buffer{std::move(other._buffer)}
+    {
+    }
+
+    auto operator=(writable_mapped_file&& other) noexcept -> writable_mapped_file& {
+        auto tmp = std::move(other);
+        std::swap(_path, tmp._path);
+        std::swap(_data, tmp._data);
+        std::swap(_size, tmp._size);
+        std::swap(_mapped, tmp._mapped);
+        std::swap(_buffer, tmp._buffer);
+        return *this;
+    }
+
+    ~writable_mapped_file() {
+#if POKER_DETAIL_HAS_MMAP
+        if (_mapped) ::munmap(_data, _size);
+#else
+        flush();
+#endif
+    }
+
+    // Opens the file at 'path', creating it if need be. A file of another
+    // size is resized, and whatever it held is lost.
+    // EXPECTS: size > 0
+    static auto open(const char* path, std::size_t size) -> std::optional<writable_mapped_file> {
+        auto result = writable_mapped_file{};
+#if POKER_DETAIL_HAS_MMAP
+        const auto fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd == -1) return std::nullopt;
+        struct stat info;
+        if (::fstat(fd, &info) == -1
+            || (static_cast<std::size_t>(info.st_size) != size
+                && (::ftruncate(fd, 0) == -1 || ::ftruncate(fd, static_cast<off_t>(size)) == -1)))
+        {
+            ::close(fd);
+            return std::nullopt;
+        }
+        const auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) return std::nullopt;
+        result._data = static_cast<unsigned char*>(address);
+        result._mapped = true;
+#else
+        result._path = path;
+        result._buffer.assign(size, 0);
+        {
+            auto in = std::ifstream{path, std::ios::binary | std::ios::ate};
+            if (in && static_cast<std::size_t>(in.tellg()) == size) {
+                in.seekg(0);
+                in.read(reinterpret_cast<char*>(result._buffer.data()), static_cast<std::streamsize>(size));
+                if (!in) std::fill(result._buffer.begin(), result._buffer.end(), 0);
+            }
+        }
+        result._data = result._buffer.data();
+        result._size = size;
+        if (!result.flush()) return std::nullopt;
+#endif
+        result._size = size;
+        return result;
+    }
+
+    auto data() const noexcept -> unsigned char* { return _data; }
+    auto size() const noexcept -> std::size_t    { return _size; }
+
+    // Writes the contents through to the file.
+    auto flush() -> bool {
+        if (_data == nullptr) return true;
+#if POKER_DETAIL_HAS_MMAP
+        return ::msync(_data, _size, MS_SYNC) == 0;
+#else
+        auto out = std::ofstream{_path, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(_data), static_cast<std::streamsize>(_size));
+        return static_cast<bool>(out);
+#endif
+    }
+
+private:
+    std::string _path;
+    unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+    bool _mapped = false;
+    std::vector<unsigned char> _buffer;
+};
+
+} // namespace poker::detail
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace poker::detail {
+
+// Returns 'num_threads', or the number of hardware threads if it is 0.
+inline auto resolve_num_threads(unsigned num_threads) noexcept -> unsigned {
+    if (num_threads != 0) return num_threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls 'f(task, worker)' for every task in [0, num_tasks) on up to
+// 'num_threads' threads, one of them the calling thread. Workers take the
+// next task as soon as they are done with one, so tasks of uneven size are
+// still spread evenly. 'worker' is in [0, num_threads) and lets tasks
+// accumulate into per-worker state without synchronization.
+template<class F>
+inline void parallel_for(std::size_t num_tasks, unsigned num_threads, F f) {
+    num_threads = static_cast<unsigned>(std::min<std::size_t>(resolve_num_threads(num_threads), std::max<std::size_t>(num_tasks, 1)));
+    auto next = std::atomic<std::size_t>{0};
+    const auto work = [&] (unsigned worker) {
+        for (auto task = next++; task < num_tasks; task = next++) f(task, worker);
+    };
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(num_threads - 1);
+    for (auto worker = 1u; worker < num_threads; ++worker) threads.emplace_back(work, worker);
+    work(0);
+    for (auto& t : threads) t.join();
+}
+
+} // namespace poker::detail
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include <poker/pot.hpp>
+#include "poker/detail/bit.hpp"
 
 namespace poker::detail {
 
@@ -41,6 +47,87 @@ public:
             break;
         }
     }
+
+    // Splits every pot between its eligible players with the best hand.
+    // 'rank_of' maps a seat index to the rank of the hand held in that seat,
+    // and is called once per player however many pots they are eligible for.
+    template<class RankOf>
+    void award(seat_array_view players, RankOf rank_of) const {
+        using rank = decltype(rank_of(seat_index{}));
+        auto ranks = std::array<rank, seat_array::num_seats>{};
+        for_each_seat(contenders(), [&] (seat_index i) { ranks[i] = rank_of(i); });
+        for (const auto& p : _pots) {
+            const auto eligible = eligible_mask(p);
+            pay(players, eligible, ranks, best_of(ranks, eligible), p.size());
+        }
+    }
+
+    // Splits every pot in half between its eligible players with the best high
+    // hand and those with the best low hand, or gives it all to the best high
+    // hands if nobody has a low. The high half gets the odd chip. 'high_of'
+    // and 'low_of' are called once per player. Low ranks which compare equal
+    // to a default-constructed one do not qualify.
+    template<class HighOf, class LowOf>
+    void award(seat_array_view players, HighOf high_of, LowOf low_of) const {
+        using high_rank = decltype(high_of(seat_index{}));
+        using low_rank = decltype(low_of(seat_index{}));
+        auto highs = std::array<high_rank, seat_array::num_seats>{};
+        auto lows = std::array<low_rank, seat_array::num_seats>{};
+        for_each_seat(contenders(), [&] (seat_index i) {
+            highs[i] = high_of(i);
+            lows[i] = low_of(i);
+        });
+        for (const auto& p : _pots) {
+            const auto eligible = eligible_mask(p);
+            const auto best_low = std::max(low_rank{}, best_of(lows, eligible));
+            const auto split = best_low != low_rank{};
+            const auto low_share = split ? p.size() / 2 : 0;
+            pay(players, eligible, highs, best_of(highs, eligible), p.size() - low_share);
+            if (split) pay(players, eligible, lows, best_low, low_share);
+        }
+    }
+
+private:
+    // One bit per seat.
+    using seat_mask = std::uint16_t;
+
+    static auto eligible_mask(const pot& p) noexcept -> seat_mask {
+        auto mask = seat_mask{0};
+        for (auto i : p.eligible_players()) mask |= static_cast<seat_mask>(1u << i);
+        return mask;
+    }
+
+    // The players eligible for any of the pots.
+    auto contenders() const noexcept -> seat_mask {
+        auto mask = seat_mask{0};
+        for (const auto& p : _pots) mask |= eligible_mask(p);
+        return mask;
+    }
+
+    template<class F>
+    static void for_each_seat(seat_mask mask, F f) {
+        for (; mask != 0; mask &= mask - 1) f(static_cast<seat_index>(countr_zero(mask)));
+    }
+
+    // EXPECTS: 'seats' is not empty.
+    template<class Rank>
+    static auto best_of(const std::array<Rank, seat_array::num_seats>& ranks, seat_mask seats) noexcept -> Rank {
+        auto best = ranks[countr_zero(seats)];
+        for_each_seat(seats, [&] (seat_index i) { best = std::max(best, ranks[i]); });
+        return best;
+    }
+
+    // Splits 'amount' between the players in 'seats' holding 'best'.
+    template<class Rank>
+    static void pay(seat_array_view players, seat_mask seats,
+                    const std::array<Rank, seat_array::num_seats>& ranks, Rank best, chips amount) {
+        auto winners = seat_mask{0};
+        for_each_seat(seats, [&] (seat_index i) {
+            if (ranks[i] == best) winners |= static_cast<seat_mask>(1u << i);
+        });
+        const auto payout = amount / static_cast<chips>(popcount(winners));
+        for_each_seat(winners, [&] (seat_index i) { players[i].add_to_stack(payout); });
+    }
 };
 
 } // namespace poker::detail
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+namespace poker::detail {
+
+constexpr auto rotl(std::uint64_t x, int k) noexcept -> std::uint64_t {
+    return x << k | x >> (64 - k);
+}
+
+// The SplitMix64 finalizer: a bijection that scrambles every bit of 'x' into
+// every bit of the result.
+constexpr auto mix64(std::uint64_t x) noexcept -> std::uint64_t {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+// SplitMix64. Mostly used to seed the other generators. Its n-th number is
+// mix64 of its seed plus n times a constant, so it is counter-based: seeded
+// with stream_seed, it gives each stream of a seed its own numbers.
+class splitmix64 {
+public:
+    using result_type = std::uint64_t;
+
+    constexpr explicit splitmix64(std::uint64_t seed) noexcept
+        : _state{seed}
+    {
+    }
+
+    static constexpr auto min() noexcept -> result_type { return 0;                                       }
+    static constexpr auto max() noexcept -> result_type { return std::numeric_limits<result_type>::max(); }
+
+    constexpr auto operator()() noexcept -> result_type {
+        return mix64(_state += 0x9e3779b97f4a7c15);
+    }
+
+private:
+    std::uint64_t _state;
+};
+
+// The seed of stream number 'stream' of 'seed', say of one hand of a
+// simulation or one batch of samples. A stream can be started from its number
+// alone, without generating the streams before it, so work split into streams
+// comes out the same however it is spread over threads.
+constexpr auto stream_seed(std::uint64_t seed, std::uint64_t stream) noexcept -> std::uint64_t {
+    return mix64(mix64(seed) ^ stream);
+}
+
+// xoshiro256**: small, fast, and good enough for simulations. Each thread
+// should own one.
+class xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    constexpr explicit xoshiro256(std::uint64_t seed) noexcept {
+        auto g = splitmix64{seed};
+        for (auto& s : _state) s = g();
+    }
+
+    static constexpr auto min() noexcept -> result_type { return 0;                                       }
+    static constexpr auto max() noexcept -> result_type { return std::numeric_limits<result_type>::max(); }
+
+    constexpr auto operator()() noexcept -> result_type {
+        const auto result = rotl(_state[1] * 5, 7) * 9;
+        const auto t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+        return result;
+    }
+
+private:
+    std::uint64_t _state[4] = {};
+};
+
+// Returns 32 uniformly distributed bits: the high bits of a 64-bit
+// generator, a 32-bit generator's numbers as they are, and whatever it takes
+// of any other generator.
+template<class URBG>
+constexpr auto random_bits_32(URBG& g) -> std::uint64_t {
+    constexpr auto min = std::uint64_t{std::remove_reference_t<URBG>::min()};
+    constexpr auto max = std::uint64_t{std::remove_reference_t<URBG>::max()};
+    if constexpr (min == 0 && max == std::numeric_limits<std::uint64_t>::max()) {
+        return static_cast<std::uint64_t>(g()) >> 32;
+    } else if constexpr (min == 0 && max == std::numeric_limits<std::uint32_t>::max()) {
+        return static_cast<std::uint64_t>(g());
+    } else {
+        return std::uniform_int_distribution<std::uint32_t>{}(g);
+    }
+}
+
+// Returns a uniformly distributed integer in [0, range) using Lemire's
+// multiply-and-reject method, which needs no division in the common case.
+// Only throws if 'g' does.
+// EXPECTS: 0 < range < 2^32
+template<class URBG>
+constexpr auto bounded(URBG& g, std::uint32_t range) -> std::uint32_t {
+    auto product = random_bits_32(g) * range;
+    if (static_cast<std::uint32_t>(product) < range) {
+        const auto threshold = static_cast<std::uint32_t>(-range) % range;
+        while (static_cast<std::uint32_t>(product) < threshold) product = random_bits_32(g) * range;
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+} // namespace poker::detail
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <poker/batch_evaluator.hpp>
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/combinations.hpp>
+#include <poker/hole_cards.hpp>
+#include <poker/range.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/parallel.hpp"
+#include "poker/detail/random.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker {
+
+// How one player fares over the boards a hand can be played out on.
+struct player_equity {
+    double equity = 0; // Share of the pot won on average.
+    double win    = 0; // Share of the boards won outright.
+    double tie    = 0; // Share of the boards on which the pot is split.
+};
+
+// When to stop sampling boards. Sampling stops as soon as any limit is met.
+struct monte_carlo_options {
+    double max_standard_error = 0.001;
+    std::chrono::nanoseconds time_budget = std::chrono::milliseconds{100};
+    std::uint64_t max_samples = std::numeric_limits<std::uint64_t>::max();
+    int num_unknown_players = 0; // Players dealt random hole cards.
+    std::uint64_t seed = 0;
+    unsigned num_threads = 0; // All of the hardware threads if 0.
+};
+
+struct equity_estimate {
+    std::vector<player_equity> players;
+    std::vector<double> standard_errors; // Of each player's equity.
+    std::uint64_t num_samples = 0;
+};
+
+} // namespace poker
+
+namespace poker::detail {
+
+constexpr auto max_equity_players = std::size_t{9};
+
+// Tallies of the boards played out by one worker, a cache line apart from the
+// tallies of the others.
+struct alignas(64) equity_counts {
+    // Pot shares are counted in 2520ths of a pot, which is divisible by every
+    // number of winners, so the tallies stay exact.
+    static constexpr auto whole_pot = std::uint64_t{2520};
+
+    std::uint64_t num_boards = 0;
+    std::array<std::uint64_t, max_equity_players> shares = {};
+    std::array<std::uint64_t, max_equity_players> wins = {};
+    std::array<std::uint64_t, max_equity_players> ties = {};
+    // Sums of the squared shares, for the variance of sampled equities.
+    std::array<std::uint64_t, max_equity_players> squared_shares = {};
+
+    // EXPECTS: 'hands' holds 2 cards per player, 'board' the 5 cards.
+    void add_board(span<const card_set> hands, card_set board) noexcept {
+        auto ranks = std::array<hand_value, max_equity_players>{};
+        auto best = hand_value{0};
+        for (auto i = std::size_t{0}; i < hands.size(); ++i) {
+            ranks[i] = evaluate_7(hands[i] | board);
+            best = std::max(best, ranks[i]);
+        }
+        add_result(ranks.data(), hands.size(), best);
+    }
+
+    void add_result(const hand_value* ranks, std::size_t num_players, hand_value best) noexcept {
+        auto num_winners = std::uint64_t{0};
+        for (auto i = std::size_t{0}; i < num_players; ++i) num_winners += ranks[i] == best;
+        for (auto i = std::size_t{0}; i < num_players; ++i) {
+            if (ranks[i] != best) continue;
+            const auto share = whole_pot / num_winners;
+            shares[i] += share;
+            squared_shares[i] += share * share;
+            ++(num_winners == 1 ? wins : ties)[i];
+        }
+        ++num_boards;
+    }
+
+    auto operator+=(const equity_counts& other) noexcept -> equity_counts& {
+        num_boards += other.num_boards;
+        for (auto i = std::size_t{0}; i < max_equity_players; ++i) {
+            shares[i] += other.shares[i];
+            wins[i] += other.wins[i];
+            ties[i] += other.ties[i];
+            squared_shares[i] += other.squared_shares[i];
+        }
+        return *this;
+    }
+
+    auto results(std::size_t num_players) const -> std::vector<player_equity> {
+        auto result = std::vector<player_equity>(num_players);
+        const auto boards = static_cast<double>(num_boards);
+        for (auto i = std::size_t{0}; i < num_players; ++i) {
+            result[i].equity = static_cast<double>(shares[i]) / (boards * whole_pot);
+            result[i].win = static_cast<double>(wins[i]) / boards;
+            result[i].tie = static_cast<double>(ties[i]) / boards;
+        }
+        return result;
+    }
+
+    // The standard error of the mean equity of player 'i' over the boards.
+    auto standard_error(std::size_t i) const noexcept -> double {
+        if (num_boards < 2) return std::numeric_limits<double>::infinity();
+        const auto n = static_cast<double>(num_boards);
+        const auto pot = static_cast<double>(whole_pot);
+        const auto mean = static_cast<double>(shares[i]) / (n * pot);
+        const auto mean_square = static_cast<double>(squared_shares[i]) / (n * pot * pot);
+        return std::sqrt(std::max(0.0, mean_square - mean * mean) / (n - 1));
+    }
+};
+
+// Returns the cards of the players' hands, and checks that no card is used
+// twice, the board included. 'num_unknown' more players are dealt at random.
+inline auto hands_of(span<const hole_cards> players, card_set board, int num_unknown = 0) POKER_NOEXCEPT
+    -> std::array<card_set, max_equity_players>
+{
+    POKER_DETAIL_ASSERT(!players.empty() && num_unknown >= 0, "There must be a known player");
+    const auto num_players = players.size() + static_cast<std::size_t>(num_unknown);
+    POKER_DETAIL_ASSERT(num_players >= 2 && num_players <= max_equity_players, "There must be 2 to 9 players");
+    (void)num_players;
+    auto hands = std::array<card_set, max_equity_players>{};
+    auto dead = board;
+    for (auto i = std::size_t{0}; i < players.size(); ++i) {
+        hands[i].insert(players[i].first);
+        hands[i].insert(players[i].second);
+        dead |= hands[i];
+    }
+    POKER_DETAIL_ASSERT(dead.size() == static_cast<int>(2 * players.size() + board.size()), "Cards must not be used twice");
+    (void)dead;
+    return hands;
+}
+
+// The cards not known to be dead, dealt in random order. Dealing swaps a
+// random undealt card to the front, so 'reset' can take the cards back
+// without restoring their order.
+class live_deck {
+public:
+    explicit live_deck(card_set dead) noexcept {
+        for (auto c : ~dead) {
+            _cards[_size] = card_set{};
+            _cards[_size++].insert(c);
+        }
+    }
+
+    // EXPECTS: Not every live card has been dealt.
+    template<class URBG>
+    auto deal(URBG& g) noexcept -> card_set {
+        const auto i = _dealt + static_cast<int>(bounded(g, static_cast<std::uint32_t>(_size - _dealt)));
+        std::swap(_cards[_dealt], _cards[i]);
+        return _cards[_dealt++];
+    }
+
+    void reset() noexcept {
+        _dealt = 0;
+    }
+
+    auto size() const noexcept -> int {
+        return _size;
+    }
+
+private:
+    std::array<card_set, 52> _cards;
+    int _size = 0;
+    int _dealt = 0;
+};
+
+// Calls 'f(board, worker)' for every 5-card board made of 'known' and cards
+// not in 'dead', spread over 'num_threads' threads. 'worker' is as for
+// parallel_for().
+// EXPECTS: 'dead' includes 'known'.
+template<class F>
+inline void for_each_runout(card_set known, card_set dead, unsigned num_threads, F f) {
+    const auto runouts = card_combinations{~dead, 5 - known.size()};
+    // Several equal ranges of runouts per thread, to make up for threads
+    // that fall behind.
+    num_threads = resolve_num_threads(num_threads);
+    const auto num_ranges = std::min<std::uint64_t>(runouts.size(), 16 * num_threads);
+    parallel_for(num_ranges, num_threads, [&] (std::size_t r, unsigned worker) {
+        const auto [first, last] = runouts.range(r, num_ranges);
+        runouts.for_each(first, last, [&] (card_set cards) { f(known | cards, worker); });
+    });
+}
+
+// Weighted tallies of range-versus-range showdowns, from the first range's
+// point of view.
+struct alignas(64) range_counts {
+    double total = 0;
+    double wins = 0;
+    double ties = 0;
+};
+
+// The combos of two ranges that can still be dealt, and the buffers to
+// evaluate them on one board at a time. One per worker.
+class range_showdown {
+public:
+    range_showdown(const hand_range& first, const hand_range& second, card_set dead) {
+        for (auto combo = std::size_t{0}; combo < num_combos; ++combo) {
+            const auto cards = combo_set(combo);
+            if ((first.weight(combo) == 0 && second.weight(combo) == 0) || !(cards & dead).empty()) continue;
+            const auto hc = combo_cards(combo);
+            _combos.push_back(combo_entry{cards, first.weight(combo), second.weight(combo),
+                                          static_cast<std::uint8_t>(to_card_index(hc.first)),
+                                          static_cast<std::uint8_t>(to_card_index(hc.second))});
+        }
+        _hands.resize(_combos.size());
+        _ranks.resize(_combos.size());
+        _order.resize(_combos.size());
+        _live.resize(_combos.size());
+    }
+
+    // Adds the showdowns on 'board' between every pair of combos that share
+    // no card. With the combos sorted by rank, the weight of the second range
+    // beaten by a combo is the weight below it less the weight of the combos
+    // holding either of its cards; the combo itself has the same rank, so it
+    // is never below.
+    void add_board(card_set board, range_counts& counts) {
+        auto n = std::size_t{0};
+        for (auto k = std::size_t{0}; k < _combos.size(); ++k) {
+            if (!(_combos[k].cards & board).empty()) continue;
+            _live[n] = static_cast<std::uint16_t>(k);
+            _hands[n++] = _combos[k].cards | board;
+        }
+        evaluate_batch({_hands.data(), n}, {_ranks.data(), n});
+        auto all = std::array<double, 53>{}; // The last entry is the sum.
+        for (auto i = std::size_t{0}; i < n; ++i) {
+            const auto& c = _combos[_live[i]];
+            all[c.first] += c.second_weight;
+            all[c.second] += c.second_weight;
+            all[52] += c.second_weight;
+            _order[i] = static_cast<std::uint32_t>(_ranks[i].value()) << 16 | static_cast<std::uint32_t>(i);
+        }
+        std::sort(_order.begin(), _order.begin() + static_cast<std::ptrdiff_t>(n));
+
+        auto below = std::array<double, 53>{};
+        auto group = std::array<double, 53>{};
+        for (auto begin = std::size_t{0}; begin < n;) {
+            const auto rank = _order[begin] >> 16;
+            auto end = begin;
+            for (; end < n && _order[end] >> 16 == rank; ++end) {
+                const auto& c = _combos[_live[_order[end] & 0xffff]];
+                group[c.first] += c.second_weight;
+                group[c.second] += c.second_weight;
+                group[52] += c.second_weight;
+            }
+            for (auto i = begin; i < end; ++i) {
+                const auto& c = _combos[_live[_order[i] & 0xffff]];
+                if (c.first_weight == 0) continue;
+                const auto beaten = below[52] - below[c.first] - below[c.second];
+                const auto tied = group[52] - group[c.first] - group[c.second] + c.second_weight;
+                const auto faced = all[52] - all[c.first] - all[c.second] + c.second_weight;
+                counts.wins += c.first_weight * beaten;
+                counts.ties += c.first_weight * tied;
+                counts.total += c.first_weight * faced;
+            }
+            for (auto i = std::size_t{0}; i < group.size(); ++i) {
+                below[i] += group[i];
+                group[i] = 0;
+            }
+            begin = end;
+        }
+    }
+
+private:
+    struct combo_entry {
+        card_set cards;
+        double first_weight;
+        double second_weight;
+        std::uint8_t first;
+        std::uint8_t second;
+    };
+
+    std::vector<combo_entry> _combos;
+    std::vector<card_set> _hands;
+    std::vector<hand_rank> _ranks;
+    std::vector<std::uint32_t> _order;
+    std::vector<std::uint16_t> _live;
+};
+
+} // namespace poker::detail
+
+namespace poker {
+
+// Works out the exact equity of every player by playing the hand out on
+// every board. 'board' holds the community cards known so far: none, the
+// flop or the turn. Boards are spread over 'num_threads' threads, all of the
+// hardware threads by default.
+inline auto exhaustive_equity(span<const hole_cards> players, span<const card> board, unsigned num_threads = 0)
+    -> std::vector<player_equity>
+{
+    POKER_DETAIL_ASSERT(board.size() != 1 && board.size() != 2 && board.size() <= 5, "The board must be empty, or hold the flop, the turn or the river");
+    const auto known = card_set{board};
+    const auto hands_array = detail::hands_of(players, known);
+    const auto hands = span<const card_set>{hands_array.data(), players.size()};
+
+    auto dead = known;
+    for (auto h : hands) dead |= h;
+    num_threads = detail::resolve_num_threads(num_threads);
+    auto counts = std::vector<detail::equity_counts>(num_threads);
+    detail::for_each_runout(known, dead, num_threads, [&] (card_set cards, unsigned worker) {
+        counts[worker].add_board(hands, cards);
+    });
+    for (auto worker = 1u; worker < num_threads; ++worker) counts[0] += counts[worker];
+    return counts[0].results(players.size());
+}
+
+// Estimates the equity of every known player by playing the hand out on
+// random boards against the known players and 'num_unknown_players' random
+// hands. The estimate is returned once the standard error of every known
+// player's equity is at most 'max_standard_error', or 'time_budget' or
+// 'max_samples' runs out. Boards are sampled in numbered batches, each from
+// its own stream of 'seed', so a run that stops at 'max_samples' gives the
+// same results for a given seed on any number of threads.
+// EXPECTS: options.max_samples > 0
+inline auto monte_carlo_equity(span<const hole_cards> players, span<const card> board, const monte_carlo_options& options = {})
+    -> equity_estimate
+{
+    POKER_DETAIL_ASSERT(board.size() <= 5, "The board must hold at most 5 cards");
+    POKER_DETAIL_ASSERT(options.max_samples > 0, "At least one board must be sampled");
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto known = card_set{board};
+    const auto num_known = players.size();
+    const auto num_players = num_known + static_cast<std::size_t>(options.num_unknown_players);
+    const auto hands_array = detail::hands_of(players, known, options.num_unknown_players);
+    auto dead = known;
+    for (auto i = std::size_t{0}; i < num_known; ++i) dead |= hands_array[i];
+    const auto to_come = 5 - static_cast<int>(board.size());
+
+    // Workers sample in batches and merge them into the total, which is
+    // where the limits are checked.
+    constexpr auto batch_size = std::uint64_t{1024};
+    auto total = detail::equity_counts{};
+    auto claimed = std::uint64_t{0};
+    auto done = false;
+    auto mutex = std::mutex{};
+    const auto precise_enough = [&] {
+        for (auto i = std::size_t{0}; i < num_known; ++i) {
+            if (!(total.standard_error(i) <= options.max_standard_error)) return false;
+        }
+        return true;
+    };
+
+    const auto num_threads = detail::resolve_num_threads(options.num_threads);
+    detail::parallel_for(num_threads, num_threads, [&] (std::size_t, unsigned) {
+        const auto full_deck = detail::live_deck{dead};
+        auto hands = hands_array;
+        auto counts = detail::equity_counts{};
+        for (;;) {
+            auto num_samples = std::uint64_t{0};
+            auto batch = std::uint64_t{0};
+            {
+                const auto lock = std::lock_guard{mutex};
+                if (done) return;
+                batch = claimed / batch_size;
+                num_samples = std::min(batch_size, options.max_samples - claimed);
+                claimed += num_samples;
+                done = claimed == options.max_samples;
+            }
+            // A batch deals from the deck in the same order on any thread.
+            auto g = detail::xoshiro256{detail::stream_seed(options.seed, batch)};
+            auto deck = full_deck;
+            for (auto s = std::uint64_t{0}; s < num_samples; ++s) {
+                deck.reset();
+                for (auto i = num_known; i < num_players; ++i) hands[i] = deck.deal(g) | deck.deal(g);
+                auto cards = known;
+                for (auto i = 0; i < to_come; ++i) cards |= deck.deal(g);
+                counts.add_board({hands.data(), num_players}, cards);
+            }
+            const auto lock = std::lock_guard{mutex};
+            total += counts;
+            counts = detail::equity_counts{};
+            if (precise_enough() || clock::now() - start >= options.time_budget) done = true;
+        }
+    });
+
+    auto result = equity_estimate{};
+    result.players = total.results(num_known);
+    for (auto i = std::size_t{0}; i < num_known; ++i) result.standard_errors.push_back(total.standard_error(i));
+    result.num_samples = total.num_boards;
+    return result;
+}
+
+// Works out the exact equity of range 'first' against range 'second' over
+// every board. Each pair of combos sharing no card, with each other or the
+// board, is dealt with a probability proportional to the product of their
+// weights. 'board' holds none, 3, 4 or 5 cards; with none, each of the 1.7M
+// boards is evaluated for every combo, which takes a while.
+inline auto range_equity(const hand_range& first, const hand_range& second, span<const card> board, unsigned num_threads = 0)
+    -> std::vector<player_equity>
+{
+    POKER_DETAIL_ASSERT(board.size() != 1 && board.size() != 2 && board.size() <= 5, "The board must be empty, or hold the flop, the turn or the river");
+    const auto known = card_set{board};
+    POKER_DETAIL_ASSERT(known.size() == static_cast<int>(board.size()), "Cards must not be used twice");
+    num_threads = detail::resolve_num_threads(num_threads);
+    auto counts = std::vector<detail::range_counts>(num_threads);
+    auto showdowns = std::vector<detail::range_showdown>(num_threads, detail::range_showdown{first, second, known});
+    detail::for_each_runout(known, known, num_threads, [&] (card_set cards, unsigned worker) {
+        showdowns[worker].add_board(cards, counts[worker]);
+    });
+    for (auto worker = 1u; worker < num_threads; ++worker) {
+        counts[0].total += counts[worker].total;
+        counts[0].wins += counts[worker].wins;
+        counts[0].ties += counts[worker].ties;
+    }
+    const auto& c = counts[0];
+    auto result = std::vector<player_equity>(2);
+    if (c.total == 0) return result;
+    const auto losses = c.total - c.wins - c.ties;
+    result[0] = player_equity{(c.wins + c.ties / 2) / c.total, c.wins / c.total, c.ties / c.total};
+    result[1] = player_equity{(losses + c.ties / 2) / c.total, losses / c.total, c.ties / c.total};
+    return result;
+}
+
+} // namespace poker
@@ -2,42 +2,28 @@
 
 #include <algorithm>
 #include <array>
-#include <cmath>
 #include <optional>
 #include <tuple>
 
 #include <poker/card.hpp>
+#include <poker/card_set.hpp>
 #include <poker/community_cards.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/hand_ranking.hpp>
 #include <poker/hole_cards.hpp>
 #include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
 #include "poker/detail/span.hpp"
 
 namespace poker {
 
-enum class hand_ranking {
-    high_card,
-    pair,
-    two_pair,
-    three_of_a_kind,
-    straight,
-    flush,
-    full_house,
-    four_of_a_kind,
-    straight_flush,
-    royal_flush
-};
-
+// Holds the rank and the cards the hand was made from. Which five of them make
+// the hand is only worked out when cards() is called.
 class hand {
-    hand_ranking _ranking;
-    int _strength;
-    std::array<card, 5> _cards;
-
-    hand(hand_ranking ranking, int strength, span<const card, 5> cards)
-        : _ranking{ranking}
-        , _strength{strength}
-    {
-        std::copy(cards.cbegin(), cards.cend(), _cards.begin());
-    }
+    card_set _cards;
+    hand_rank _rank;
+
+    hand(hand_ranking ranking, int strength, span<const card, 5> cards) noexcept;
 
 public:
     static auto _high_low_hand_eval(span<card, 7> cards) noexcept -> hand;
@@ -50,13 +36,14 @@ public:
 
     hand(span<card, 7> cards) noexcept;
 
-    auto ranking()  const noexcept -> hand_ranking        { return _ranking;  }
-    auto strength() const noexcept -> int                 { return _strength; }
-    auto cards()    const noexcept -> span<const card, 5> { return _cards;    }
+    auto rank()     const noexcept -> hand_rank           { return _rank;           }
+    auto ranking()  const noexcept -> hand_ranking        { return _rank.ranking(); }
+    auto strength() const noexcept -> int;
+    auto cards()    const noexcept -> std::array<card, 5>;
 };
 
 inline auto operator==(const hand& lhs, const hand& rhs) noexcept -> bool {
-    return lhs.ranking() == rhs.ranking() && lhs.strength() == rhs.strength();
+    return lhs.rank() == rhs.rank();
 }
 
 inline auto operator!=(const hand& lhs, const hand& rhs) noexcept -> bool {
@@ -64,11 +51,7 @@ inline auto operator!=(const hand& lhs, const hand& rhs) noexcept -> bool {
 }
 
 inline auto operator<(const hand& lhs, const hand& rhs) noexcept -> bool {
-    const auto r1 = lhs.ranking();
-    const auto s1 = lhs.strength();
-    const auto r2 = rhs.ranking();
-    const auto s2 = rhs.strength();
-    return std::tie(r1, s1) < std::tie(r2, s2);
+    return lhs.rank() < rhs.rank();
 }
 
 inline auto operator>(const hand& lhs, const hand& rhs) noexcept -> bool {
@@ -106,10 +89,12 @@ constexpr auto next_rank(span<const card> cards) noexcept -> rank_info {
     return {first_rank, second_rank_index};
 }
 
+inline constexpr int powers_of_13[] = {1, 13, 13*13, 13*13*13, 13*13*13*13};
+
 inline auto get_strength(span<const card, 5> arg_cards) noexcept -> int {
     auto cards = span<const card>(arg_cards);
     auto sum = 0;
-    auto multiplier = static_cast<int>(std::pow(13, 4));
+    auto multiplier = powers_of_13[4];
     for (;;) {
         /* const auto [rank, count] = next_rank(cards); */
         const auto tmp = next_rank(cards);
@@ -126,10 +111,80 @@ inline auto get_strength(span<const card, 5> arg_cards) noexcept -> int {
     return sum;
 }
 
+// hand::strength() holds the ranks of the groups of equally ranked cards, most
+// significant group first, as base-13 digits starting at 13^4. Straights only
+// hold the rank of their highest card, and royal flushes hold 0.
+inline auto hand_value_strength(hand_value value) noexcept -> int {
+    const auto ranks = hand_value_ranks(value);
+    switch (hand_value_ranking(value)) {
+    case hand_ranking::straight:
+    case hand_ranking::straight_flush:
+        return ranks[0];
+    case hand_ranking::royal_flush:
+        return 0;
+    default:
+        break;
+    }
+    auto sum = 0;
+    auto digit = 4;
+    for (auto i = 0; i < 5; ++i) {
+        if (i == 0 || ranks[i] != ranks[i-1]) sum += powers_of_13[digit--] * ranks[i];
+    }
+    return sum;
+}
+
+// Inverse of hand_value_strength().
+inline auto hand_value_from_strength(hand_ranking ranking, int strength) noexcept -> hand_value {
+    const auto digit = [&] (int i) { return strength / powers_of_13[4 - i] % 13; };
+    const auto ranks_mask = [&] (int first, int last) {
+        auto mask = 0u;
+        for (auto i = first; i < last; ++i) mask |= 1u << digit(i);
+        return mask;
+    };
+    switch (ranking) {
+    case hand_ranking::high_card:
+    case hand_ranking::flush:
+        return make_hand_value(ranking, colex_index(ranks_mask(0, 5)));
+    case hand_ranking::pair:
+        return make_hand_value(ranking, digit(0) * binomial(13, 3) + colex_index(ranks_mask(1, 4)));
+    case hand_ranking::two_pair:
+        return make_hand_value(ranking, colex_index(ranks_mask(0, 2)) * 13 + digit(2));
+    case hand_ranking::three_of_a_kind:
+        return make_hand_value(ranking, digit(0) * binomial(13, 2) + colex_index(ranks_mask(1, 3)));
+    case hand_ranking::straight:
+    case hand_ranking::straight_flush:
+        return make_hand_value(ranking, strength);
+    case hand_ranking::royal_flush:
+        return make_hand_value(ranking, 0);
+    case hand_ranking::full_house:
+    case hand_ranking::four_of_a_kind:
+        return make_hand_value(ranking, digit(0) * 13 + digit(1));
+    }
+    return 0;
+}
+
 } // namespace poker::detail
 
 namespace poker {
 
+inline hand::hand(hand_ranking ranking, int strength, span<const card, 5> cards) noexcept
+    : _cards{cards}
+    , _rank{detail::hand_value_from_strength(ranking, strength)}
+{
+}
+
+inline auto hand::strength() const noexcept -> int {
+    return detail::hand_value_strength(_rank.value());
+}
+
+inline auto hand::cards() const noexcept -> std::array<card, 5> {
+    return detail::hand_value_cards(_rank.value(), _cards);
+}
+
+} // namespace poker
+
+namespace poker {
+
 inline auto hand::_high_low_hand_eval(span<card, 7> cards) noexcept -> hand {
     using poker::detail::get_strength, poker::detail::next_rank;
 
@@ -154,10 +209,10 @@ inline auto hand::_high_low_hand_eval(span<card, 7> cards) noexcept -> hand {
     const auto tmp = next_rank(cards);
     /* const auto rank = tmp.rank; // UNUSED VARIABLE */
     const auto count = tmp.count;
+    const auto greater_rank = [] (card x, card y) -> bool {
+        return x.rank > y.rank;
+    };
     if (count == 4) {
-        const auto greater_rank = [] (card x, card y) -> bool {
-            return x.rank > y.rank;
-        };
         std::sort(cards.begin() + 4, cards.end(), greater_rank);
         ranking = hand_ranking::four_of_a_kind;
     } else if (count == 3) {
@@ -165,7 +220,7 @@ inline auto hand::_high_low_hand_eval(span<card, 7> cards) noexcept -> hand {
         const auto tmp = next_rank(cards.last<4>());
         /* const auto rank = tmp.rank; // UNUSED VARIABLE */
         const auto count = tmp.count;
-        if (count == 2) {
+        if (count >= 2) { // A second three of a kind also makes a full house.
             ranking = hand_ranking::full_house;
         } else {
             ranking = hand_ranking::three_of_a_kind;
@@ -176,6 +231,8 @@ inline auto hand::_high_low_hand_eval(span<card, 7> cards) noexcept -> hand {
         /* const auto rank = tmp.rank; // UNUSED VARIABLE */
         const auto count = tmp.count;
         if (count == 2) {
+            // With three pairs, the third one may not hold the best kicker.
+            std::sort(cards.begin() + 4, cards.end(), greater_rank);
             ranking = hand_ranking::two_pair;
         } else {
             ranking = hand_ranking::pair;
@@ -291,20 +348,18 @@ inline auto hand::_straight_flush_eval(span<card, 7> cards) noexcept -> std::opt
 
 inline hand::hand(const hole_cards& hc, const community_cards& cc) POKER_NOEXCEPT {
     POKER_DETAIL_ASSERT(cc.cards().size() == 5, "All community cards must be dealt");
-    auto cards = std::array<card, 7>{};
-    cards[0] = hc.first;
-    cards[1] = hc.second;
-    std::copy(cc.cards().cbegin(), cc.cards().cend(), cards.begin() + 2);
-    *this = hand{cards};
+    _cards = card_set{cc.cards()};
+    _cards.insert(hc.first);
+    _cards.insert(hc.second);
+    _rank = hand_rank{detail::evaluate_7(_cards)};
 }
 
-inline hand::hand(span<card, 7> cards) noexcept {
-    auto h1 = _high_low_hand_eval(cards);
-    if (auto h2 = _straight_flush_eval(cards)) {
-        *this = std::max(h1, *h2);
-    } else {
-        *this = h1;
-    }
+// The sort-based _high_low_hand_eval() and _straight_flush_eval() are kept as
+// the reference the table-driven evaluator is tested against.
+inline hand::hand(span<card, 7> cards) noexcept
+    : _cards{cards}
+    , _rank{detail::evaluate_7(_cards)}
+{
 }
 
 } // namespace poker
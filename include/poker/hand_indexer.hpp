@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/combinations.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/error.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker::detail {
+
+// EXPECTS: The result fits in 64 bits.
+constexpr auto choose(std::uint64_t n, int k) noexcept -> std::uint64_t {
+    if (k < 0 || static_cast<std::uint64_t>(k) > n) return 0;
+    if (n < binomials.size()) return binomials[n][k];
+    auto result = std::uint64_t{1};
+    for (auto i = 0; i < k; ++i) result = result * (n - i) / (i + 1);
+    return result;
+}
+
+// Index of the sorted multiset 'a[0] <= ... <= a[k-1]' among the multisets of
+// 'k' numbers. Adding 'i' to 'a[i]' makes the numbers distinct, which turns
+// the multiset into a set that is numbered colexicographically.
+inline auto multiset_index(const std::uint64_t* a, int k) noexcept -> std::uint64_t {
+    auto index = std::uint64_t{0};
+    for (auto i = 0; i < k; ++i) index += choose(a[i] + i, i + 1);
+    return index;
+}
+
+// Inverse of multiset_index(), given that the numbers are less than 'n'.
+inline void multiset_unindex(std::uint64_t index, int k, std::uint64_t n, std::uint64_t* a) noexcept {
+    for (auto i = k - 1; i >= 0; --i) {
+        // The greatest 'b' with choose(b, i + 1) <= index.
+        auto lo = static_cast<std::uint64_t>(i), hi = n - 1 + i;
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo + 1) / 2;
+            if (choose(mid, i + 1) <= index) lo = mid; else hi = mid - 1;
+        }
+        index -= choose(lo, i + 1);
+        a[i] = lo - i;
+    }
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// Numbers the deals that differ in more than their suits densely, one round
+// at a time. A deal is the cards of the rounds so far, in order, e.g. the hole
+// cards and then the flop. Index 0 to size(round) - 1 each stand for one class
+// of deals, so tables keyed by deals can be flat arrays. For hold'em, there
+// are 169, 1286792, 55190538 and 2428287420 of them. Dealing the board as one
+// round instead, i.e. not telling the turn from the flop, leaves 13960050
+// turns and 123156254 rivers.
+//
+// The cards of a suit in each round make up its shape (how many of them there
+// are per round) and its index among the cards of that shape. Relabelling the
+// suits only reorders them, so a deal is numbered by its suits' shapes in
+// descending order, its configuration, and then by the multisets of indices
+// of the suits sharing a shape.
+class hand_indexer {
+public:
+    static constexpr auto max_rounds = 8;
+
+    // EXPECTS: 1 <= cards_per_round.size() <= max_rounds, at most 52 cards in
+    //          total.
+    explicit hand_indexer(span<const int> cards_per_round) POKER_NOEXCEPT;
+
+    // Two hole cards, the flop, the turn and the river.
+    static auto holdem() -> hand_indexer;
+
+    auto num_rounds() const noexcept -> int {
+        return static_cast<int>(_cards_per_round.size());
+    }
+
+    // The number of cards dealt up to and including 'round'.
+    auto num_cards(int round) const POKER_NOEXCEPT -> int;
+
+    // The number of classes of deals up to and including 'round'.
+    auto size(int round) const POKER_NOEXCEPT -> std::uint64_t;
+
+    // EXPECTS: 'cards' are distinct and are the cards of all the rounds up to
+    //          some round, in order.
+    auto index(span<const card> cards) const POKER_NOEXCEPT -> std::uint64_t;
+
+    auto index(const hole_cards& hc, span<const card> board) const POKER_NOEXCEPT -> std::uint64_t;
+
+    // Writes the representative deal of class 'index' of 'round' to 'cards'.
+    // EXPECTS: index < size(round), cards.size() == num_cards(round)
+    void unindex(int round, std::uint64_t index, span<card> cards) const POKER_NOEXCEPT;
+
+private:
+    // A shape holds 4 bits per round, the first round highest, so shapes
+    // compare the way their counts do.
+    using shape = std::uint32_t;
+
+    struct configuration {
+        std::array<shape, 4> shapes;  // Descending.
+        std::uint64_t offset;
+    };
+
+    static constexpr auto shape_count(shape s, int round) noexcept -> int {
+        return static_cast<int>(s >> 4 * (max_rounds - 1 - round) & 0xf);
+    }
+
+    // The number of ways the cards of a suit can make the shape.
+    static auto shape_size(shape s, int num_rounds) noexcept -> std::uint64_t;
+
+    void add_configurations(int round, int suit, std::array<shape, 4>& shapes, std::array<int, max_rounds>& remaining);
+
+    std::vector<int> _cards_per_round;
+    std::vector<std::vector<configuration>> _configurations;
+    std::vector<std::uint64_t> _sizes;
+};
+
+inline hand_indexer::hand_indexer(span<const int> cards_per_round) POKER_NOEXCEPT
+    : _cards_per_round(cards_per_round.begin(), cards_per_round.end())
+{
+    POKER_DETAIL_ASSERT(!_cards_per_round.empty() && num_rounds() <= max_rounds, "Invalid number of rounds");
+    auto total = 0;
+    for (auto n : _cards_per_round) {
+        POKER_DETAIL_ASSERT(n >= 0 && n <= 13, "Invalid number of cards");
+        total += n;
+    }
+    POKER_DETAIL_ASSERT(total <= 52, "Too many cards");
+    for (auto round = 0; round < num_rounds(); ++round) {
+        auto shapes = std::array<shape, 4>{};
+        auto remaining = std::array<int, max_rounds>{};
+        for (auto r = 0; r <= round; ++r) remaining[r] = _cards_per_round[r];
+        _configurations.emplace_back();
+        add_configurations(round, 0, shapes, remaining);
+        auto& configurations = _configurations.back();
+        std::sort(configurations.begin(), configurations.end(), [] (const configuration& x, const configuration& y) {
+            return x.shapes < y.shapes;
+        });
+        auto offset = std::uint64_t{0};
+        for (auto& c : configurations) {
+            c.offset = offset;
+            auto size = std::uint64_t{1};
+            for (auto i = 0; i < 4;) {
+                auto j = i + 1;
+                while (j < 4 && c.shapes[j] == c.shapes[i]) ++j;
+                // Equally shaped suits are numbered as a multiset, of which
+                // there are choose(n + k - 1, k).
+                const auto n = shape_size(c.shapes[i], round + 1);
+                size *= detail::choose(n + (j - i) - 1, j - i);
+                i = j;
+            }
+            offset += size;
+        }
+        _sizes.push_back(offset);
+    }
+}
+
+inline auto hand_indexer::holdem() -> hand_indexer {
+    static constexpr int cards_per_round[] = {2, 3, 1, 1};
+    return hand_indexer{cards_per_round};
+}
+
+inline auto hand_indexer::num_cards(int round) const POKER_NOEXCEPT -> int {
+    POKER_DETAIL_ASSERT(round >= 0 && round < num_rounds(), "Invalid round");
+    auto result = 0;
+    for (auto r = 0; r <= round; ++r) result += _cards_per_round[r];
+    return result;
+}
+
+inline auto hand_indexer::size(int round) const POKER_NOEXCEPT -> std::uint64_t {
+    POKER_DETAIL_ASSERT(round >= 0 && round < num_rounds(), "Invalid round");
+    return _sizes[round];
+}
+
+inline auto hand_indexer::shape_size(shape s, int num_rounds) noexcept -> std::uint64_t {
+    auto result = std::uint64_t{1};
+    auto free = 13;
+    for (auto r = 0; r < num_rounds; ++r) {
+        result *= detail::choose(free, shape_count(s, r));
+        free -= shape_count(s, r);
+    }
+    return result;
+}
+
+inline void hand_indexer::add_configurations(int round, int suit, std::array<shape, 4>& shapes, std::array<int, max_rounds>& remaining) {
+    if (suit == 4) {
+        for (auto r = 0; r <= round; ++r) {
+            if (remaining[r] != 0) return;
+        }
+        _configurations[round].push_back({shapes, 0});
+        return;
+    }
+    // Try every shape the remaining cards allow that is not greater than the
+    // shape of the previous suit.
+    auto counts = std::array<int, max_rounds>{};
+    for (;;) {
+        auto s = shape{0};
+        for (auto r = 0; r <= round; ++r) s |= static_cast<shape>(counts[r]) << 4 * (max_rounds - 1 - r);
+        auto total = 0;
+        for (auto r = 0; r <= round; ++r) total += counts[r];
+        if (total <= 13 && (suit == 0 || s <= shapes[suit - 1])) {
+            shapes[suit] = s;
+            for (auto r = 0; r <= round; ++r) remaining[r] -= counts[r];
+            add_configurations(round, suit + 1, shapes, remaining);
+            for (auto r = 0; r <= round; ++r) remaining[r] += counts[r];
+        }
+        auto r = round;
+        while (r >= 0 && counts[r] == remaining[r]) counts[r--] = 0;
+        if (r < 0) break;
+        ++counts[r];
+    }
+}
+
+inline auto hand_indexer::index(span<const card> cards) const POKER_NOEXCEPT -> std::uint64_t {
+    auto round = 0;
+    auto num_cards = _cards_per_round[0];
+    while (num_cards < static_cast<int>(cards.size()) && round + 1 < num_rounds()) {
+        num_cards += _cards_per_round[++round];
+    }
+    POKER_DETAIL_ASSERT(num_cards == static_cast<int>(cards.size()), "Invalid number of cards");
+
+    // The shape of each suit and its index among the cards of that shape.
+    auto shapes = std::array<shape, 4>{};
+    auto indices = std::array<std::uint64_t, 4>{};
+    auto multipliers = std::array<std::uint64_t, 4>{1, 1, 1, 1};
+    auto used = std::array<unsigned, 4>{};
+    auto first = std::size_t{0};
+    for (auto r = 0; r <= round; ++r) {
+        auto masks = std::array<unsigned, 4>{};
+        for (auto i = first; i < first + _cards_per_round[r]; ++i) {
+            const auto suit = static_cast<int>(cards[i].suit);
+            const auto bit = 1u << static_cast<int>(cards[i].rank);
+            POKER_DETAIL_ASSERT(((used[suit] | masks[suit]) & bit) == 0, "Cards must not be used twice");
+            masks[suit] |= bit;
+        }
+        first += _cards_per_round[r];
+        for (auto s = 0; s < 4; ++s) {
+            // The colexicographic index of the ranks among those not used by
+            // the earlier rounds.
+            const auto count = detail::popcount(masks[s]);
+            const auto index = detail::colex_rank(detail::extract_bits(masks[s], ~used[s] & 0x1fff));
+            const auto num_free = 13 - detail::popcount(used[s]);
+            indices[s] += multipliers[s] * index;
+            multipliers[s] *= detail::choose(num_free, count);
+            shapes[s] |= static_cast<shape>(count) << 4 * (max_rounds - 1 - r);
+            used[s] |= masks[s];
+        }
+    }
+
+    auto order = std::array<int, 4>{0, 1, 2, 3};
+    std::sort(order.begin(), order.end(), [&] (int x, int y) {
+        return shapes[x] != shapes[y] ? shapes[x] > shapes[y] : indices[x] < indices[y];
+    });
+    auto sorted_shapes = std::array<shape, 4>{};
+    auto sorted_indices = std::array<std::uint64_t, 4>{};
+    for (auto i = 0; i < 4; ++i) {
+        sorted_shapes[i] = shapes[order[i]];
+        sorted_indices[i] = indices[order[i]];
+    }
+    const auto& configurations = _configurations[round];
+    const auto it = std::lower_bound(configurations.begin(), configurations.end(), sorted_shapes, [] (const configuration& c, const std::array<shape, 4>& s) {
+        return c.shapes < s;
+    });
+    POKER_DETAIL_ASSERT(it != configurations.end() && it->shapes == sorted_shapes, "Invalid deal");
+
+    auto index = std::uint64_t{0};
+    auto multiplier = std::uint64_t{1};
+    for (auto i = 0; i < 4;) {
+        auto j = i + 1;
+        while (j < 4 && sorted_shapes[j] == sorted_shapes[i]) ++j;
+        const auto n = multipliers[order[i]];
+        index += multiplier * detail::multiset_index(sorted_indices.data() + i, j - i);
+        multiplier *= detail::choose(n + (j - i) - 1, j - i);
+        i = j;
+    }
+    return it->offset + index;
+}
+
+inline auto hand_indexer::index(const hole_cards& hc, span<const card> board) const POKER_NOEXCEPT -> std::uint64_t {
+    auto cards = std::array<card, 52>{};
+    POKER_DETAIL_ASSERT(board.size() <= 50, "Too many cards");
+    cards[0] = hc.first;
+    cards[1] = hc.second;
+    std::copy(board.begin(), board.end(), cards.begin() + 2);
+    return index(span<const card>(cards).first(2 + board.size()));
+}
+
+inline void hand_indexer::unindex(int round, std::uint64_t index, span<card> cards) const POKER_NOEXCEPT {
+    POKER_DETAIL_ASSERT(index < size(round), "Invalid index");
+    POKER_DETAIL_ASSERT(static_cast<int>(cards.size()) == num_cards(round), "Invalid number of cards");
+    const auto& configurations = _configurations[round];
+    const auto it = std::upper_bound(configurations.begin(), configurations.end(), index, [] (std::uint64_t i, const configuration& c) {
+        return i < c.offset;
+    }) - 1;
+    index -= it->offset;
+
+    // The index of each suit among the cards of its shape. Suit 'i' takes the
+    // 'i'th shape of the configuration.
+    auto indices = std::array<std::uint64_t, 4>{};
+    for (auto i = 0; i < 4;) {
+        auto j = i + 1;
+        while (j < 4 && it->shapes[j] == it->shapes[i]) ++j;
+        const auto n = shape_size(it->shapes[i], round + 1);
+        const auto group_size = detail::choose(n + (j - i) - 1, j - i);
+        detail::multiset_unindex(index % group_size, j - i, n, indices.data() + i);
+        index /= group_size;
+        i = j;
+    }
+
+    auto first = std::size_t{0};
+    auto used = std::array<unsigned, 4>{};
+    for (auto r = 0; r <= round; ++r) {
+        auto next = first;
+        for (auto s = 0; s < 4; ++s) {
+            const auto count = shape_count(it->shapes[s], r);
+            const auto num_free = 13 - detail::popcount(used[s]);
+            const auto size = detail::choose(num_free, count);
+            const auto positions = detail::colex_unrank(indices[s] % size, num_free, count);
+            indices[s] /= size;
+            for (auto ranks = detail::deposit_bits(positions, ~used[s] & 0x1fff); ranks != 0; ranks &= ranks - 1) {
+                const auto rank = detail::countr_zero(ranks);
+                cards[next++] = card{static_cast<card_rank>(rank), static_cast<card_suit>(s)};
+            }
+        }
+        for (auto i = first; i < next; ++i) {
+            used[static_cast<int>(cards[i].suit)] |= 1u << static_cast<int>(cards[i].rank);
+        }
+        first = next;
+    }
+}
+
+} // namespace poker
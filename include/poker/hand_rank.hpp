@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/community_cards.hpp>
+#include <poker/hand_ranking.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker {
+
+// The strength of a hand packed into 16 bits. Ranks compare exactly the way
+// the hands they were evaluated from do, so finding the winners of a showdown
+// is a search for the maximum integer.
+//
+// 'Rules' says how the hands of a game are ranked. It provides
+//
+//     static auto evaluate(card_set) -> std::uint16_t;
+//     static auto ranking(std::uint16_t value) -> hand_ranking;
+//
+// so that code written against basic_hand_rank works for any game, without
+// paying for virtual calls.
+template<class Rules>
+class basic_hand_rank {
+    std::uint16_t _value = 0;
+
+public:
+    using rules = Rules;
+
+    constexpr basic_hand_rank() noexcept = default;
+
+    constexpr explicit basic_hand_rank(std::uint16_t value) noexcept
+        : _value{value}
+    {
+    }
+
+    constexpr auto value()   const noexcept -> std::uint16_t { return _value;                 }
+    constexpr auto ranking() const noexcept -> hand_ranking  { return Rules::ranking(_value); }
+};
+
+template<class R> constexpr auto operator==(basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() == rhs.value(); }
+template<class R> constexpr auto operator!=(basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() != rhs.value(); }
+template<class R> constexpr auto operator< (basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() <  rhs.value(); }
+template<class R> constexpr auto operator> (basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() >  rhs.value(); }
+template<class R> constexpr auto operator<=(basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() <= rhs.value(); }
+template<class R> constexpr auto operator>=(basic_hand_rank<R> lhs, basic_hand_rank<R> rhs) noexcept -> bool { return lhs.value() >= rhs.value(); }
+
+// Evaluates 'cards' under the rules of any game.
+template<class Rules>
+inline auto evaluate_rank(card_set cards) POKER_NOEXCEPT -> basic_hand_rank<Rules> {
+    return basic_hand_rank<Rules>{Rules::evaluate(cards)};
+}
+
+// High hands, ranked the standard way.
+struct standard_rules {
+    static auto evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t;
+
+    static constexpr auto ranking(std::uint16_t value) noexcept -> hand_ranking {
+        return detail::hand_value_ranking(value);
+    }
+};
+
+using hand_rank = basic_hand_rank<standard_rules>;
+
+// Evaluates the best five out of five, six or seven cards without working out
+// which five cards those are. Ranks of hands with different numbers of cards
+// are on the same scale.
+inline auto evaluate_rank(card_set cards) POKER_NOEXCEPT -> hand_rank {
+    switch (cards.size()) {
+    case 5:  return hand_rank{detail::evaluate_5(cards)};
+    case 6:  return hand_rank{detail::evaluate_6(cards)};
+    case 7:  return hand_rank{detail::evaluate_7(cards)};
+    default: POKER_DETAIL_ASSERT(false, "Five, six or seven cards must be evaluated"); return hand_rank{};
+    }
+}
+
+inline auto evaluate_rank(span<const card> cards) POKER_NOEXCEPT -> hand_rank {
+    return evaluate_rank(card_set{cards});
+}
+
+// Evaluates the hand as it stands on the flop, the turn or the river.
+inline auto evaluate_rank(const hole_cards& hc, const community_cards& cc) POKER_NOEXCEPT -> hand_rank {
+    POKER_DETAIL_ASSERT(cc.cards().size() >= 3, "The flop must be dealt");
+    auto cards = card_set{cc.cards()};
+    cards.insert(hc.first);
+    cards.insert(hc.second);
+    return evaluate_rank(cards);
+}
+
+inline auto standard_rules::evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t {
+    return evaluate_rank(cards).value();
+}
+
+} // namespace poker
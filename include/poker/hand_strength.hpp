@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/parallel.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker {
+
+// How a hand stands against a random opponent hand on the current board, and
+// how that may change by the river.
+struct hand_strength_metrics {
+    double strength = 0;           // Share of the pot won now, against every opponent.
+    double positive_potential = 0; // Chance of getting ahead when behind now.
+    double negative_potential = 0; // Chance of falling behind when ahead now.
+    double effective_strength = 0; // Share of the pot won, given the potentials.
+};
+
+} // namespace poker
+
+namespace poker::detail {
+
+enum showdown_outcome : std::uint8_t { ahead, tied, behind };
+
+// Tallies of the outcomes against the opponent hands, indexed by the outcome
+// on the current board and the outcome on a later one.
+using outcome_counts = std::array<std::array<std::uint64_t, 3>, 3>;
+
+// The opponent hands that can be dealt on boards of the same ranks, counted
+// by their pair of ranks, and what the hands of each pair are worth unless
+// they make a flush.
+struct rank_pairs {
+    static constexpr auto size = 91;
+
+    std::array<int, 13> live_counts; // Cards of each rank left to deal.
+    std::array<int, size> counts;
+    std::array<hand_value, size> values;
+};
+
+// The opponent hands that can be dealt besides the known cards, and how they
+// fare against the hand on the current board.
+//
+// Unless it makes a flush, an opponent hand is only as strong as its ranks,
+// so the hands are counted by their pair of ranks from the number of live
+// cards of each rank, and evaluated a pair at a time. Boards that only differ
+// in their suits share these, so 91 lookups go a long way. Only the hands
+// making a flush are dealt and evaluated one by one.
+class opponent_hands {
+public:
+    // EXPECTS: 'board' holds 3 to 5 cards, none of them in 'hole'.
+    opponent_hands(card_set hole, card_set board) noexcept
+        : _hole{hole}
+        , _board{board}
+        , _rank{evaluate_rank(hole | board)}
+    {
+        for (auto c : ~(hole | board)) _live[_num_live++] = card_set{{&c, 1}};
+        // Every hand ranks the same on the current board as its pair of ranks
+        // does, flushes aside.
+        const auto pairs = rank_pairs_of(board);
+        for (auto p = 0; p < rank_pairs::size; ++p) {
+            if (pairs.counts[p] != 0) _pair_outcomes[p] = outcome(_rank, pairs.values[p]);
+        }
+        auto now = outcome_counts{};
+        add_board(board, pairs, _rank, now);
+        for (auto o = 0; o < 3; ++o) _totals[o] = now[o][o];
+    }
+
+    auto num_live() const noexcept -> int { return _num_live; }
+    auto live(int i) const noexcept -> card_set { return _live[i]; }
+
+    // The number of opponent hands the hand is ahead of, tied with and behind.
+    auto totals() const noexcept -> const std::array<std::uint64_t, 3>& { return _totals; }
+
+    // EXPECTS: 'board' holds the current board and the cards dealt since.
+    auto rank_pairs_of(card_set board) const noexcept -> rank_pairs {
+        auto result = rank_pairs{};
+        auto& live_counts = result.live_counts;
+        live_counts = {4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+        for (auto c : _hole | board) --live_counts[static_cast<int>(c.rank)];
+        const auto board_key = rank_key(board);
+        const auto& tables = evaluator_tables::get();
+        for (auto p = 0; p < rank_pairs::size; ++p) {
+            const auto lo = pair_ranks[p][0], hi = pair_ranks[p][1];
+            result.counts[p] = lo == hi ? live_counts[lo] * (live_counts[lo] - 1) / 2 : live_counts[lo] * live_counts[hi];
+            result.values[p] = 0;
+            if (result.counts[p] == 0) continue;
+            const auto key = board_key + rank_keys[lo] + rank_keys[hi];
+            switch (board.size()) {
+            case 3:  result.values[p] = tables.unsuited_5(key); break;
+            case 4:  result.values[p] = tables.unsuited_6(key); break;
+            default: result.values[p] = tables.unsuited_7(key); break;
+            }
+        }
+        return result;
+    }
+
+    // Adds the outcomes against every hand that can still be dealt on
+    // 'board', on which the hand is ranked 'rank'.
+    // EXPECTS: 'pairs' is rank_pairs_of() a board of the same ranks.
+    void add_board(card_set board, const rank_pairs& pairs, hand_rank rank, outcome_counts& counts) const noexcept {
+        auto pair_counts = pairs.counts;
+        const auto& tables = evaluator_tables::get();
+        // Hands making a flush are taken out of the pair counts. A hand makes
+        // a flush in the suit with 3 cards on the board, if any, and what it
+        // is worth only depends on its cards of that suit. A hand making a
+        // flush on the current board makes one on 'board' as well, so the
+        // hands left in the pair counts make no flush on either.
+        for (auto suit = 0; suit < 4; ++suit) {
+            const auto board_mask = board.suit_mask(static_cast<card_suit>(suit));
+            const auto on_board = popcount(board_mask);
+            if (on_board < 3) continue;
+            const auto now_mask = _board.suit_mask(static_cast<card_suit>(suit));
+            const auto live_mask = (~(_hole | board)).suit_mask(static_cast<card_suit>(suit));
+            auto other_counts = pairs.live_counts;
+            for (auto r = 0; r < 13; ++r) other_counts[r] -= live_mask >> r & 1;
+            // Adds 'n' hands of pair 'p' holding the ranks in 'mask' in the suit.
+            const auto add_hands = [&] (int p, unsigned mask, int n) {
+                pair_counts[p] -= n;
+                const auto now = popcount(now_mask | mask) >= 5 ? outcome(_rank, tables.flush(now_mask | mask)) : _pair_outcomes[p];
+                counts[now][outcome(rank, tables.flush(board_mask | mask))] += static_cast<std::uint64_t>(n);
+            };
+            for (auto x = 0; x < 13; ++x) {
+                if (!(live_mask >> x & 1)) continue;
+                for (auto y = x + 1; y < 13; ++y) {
+                    if (live_mask >> y & 1) add_hands(pair_index(x, y), 1u << x | 1u << y, 1);
+                }
+                if (on_board < 4) continue;
+                for (auto r = 0; r < 13; ++r) {
+                    if (other_counts[r] != 0) add_hands(pair_index(x, r), 1u << x, other_counts[r]);
+                }
+            }
+            if (on_board < 5) continue;
+            for (auto p = 0; p < rank_pairs::size; ++p) {
+                const auto lo = other_counts[pair_ranks[p][0]], hi = other_counts[pair_ranks[p][1]];
+                const auto n = pair_ranks[p][0] == pair_ranks[p][1] ? lo * (lo - 1) / 2 : lo * hi;
+                if (n != 0) add_hands(p, 0, n);
+            }
+        }
+        for (auto p = 0; p < rank_pairs::size; ++p) {
+            counts[_pair_outcomes[p]][outcome(rank, pairs.values[p])] += static_cast<std::uint64_t>(pair_counts[p]);
+        }
+    }
+
+private:
+    static auto outcome(hand_rank rank, hand_value value) noexcept -> showdown_outcome {
+        return rank.value() > value ? ahead : rank.value() == value ? tied : behind;
+    }
+
+    // Pairs of ranks 'lo <= hi' are numbered 'hi * (hi + 1) / 2 + lo'.
+    static constexpr auto pair_ranks = [] {
+        auto result = std::array<std::array<std::uint8_t, 2>, rank_pairs::size>{};
+        for (auto hi = 0; hi < 13; ++hi) {
+            for (auto lo = 0; lo <= hi; ++lo) result[hi * (hi + 1) / 2 + lo] = {static_cast<std::uint8_t>(lo), static_cast<std::uint8_t>(hi)};
+        }
+        return result;
+    }();
+
+    static auto pair_index(int x, int y) noexcept -> int {
+        const auto lo = std::min(x, y), hi = std::max(x, y);
+        return hi * (hi + 1) / 2 + lo;
+    }
+
+    card_set _hole;
+    card_set _board;
+    hand_rank _rank;
+    std::array<card_set, 50> _live;
+    int _num_live = 0;
+    std::array<showdown_outcome, rank_pairs::size> _pair_outcomes = {};
+    std::array<std::uint64_t, 3> _totals = {};
+};
+
+// One per worker.
+struct alignas(64) potential_counts {
+    outcome_counts counts = {};
+};
+
+inline auto hole_and_board(const hole_cards& hc, span<const card> board) POKER_NOEXCEPT -> std::array<card_set, 2> {
+    POKER_DETAIL_ASSERT(board.size() >= 3 && board.size() <= 5, "The board must hold the flop, the turn or the river");
+    auto hole = card_set{};
+    hole.insert(hc.first);
+    hole.insert(hc.second);
+    const auto board_set = card_set{board};
+    POKER_DETAIL_ASSERT(hole.size() == 2 && board_set.size() == static_cast<int>(board.size()) && (hole & board_set).empty(),
+                        "Cards must not be used twice");
+    return {hole, board_set};
+}
+
+// The share of the pot won against one opponent, raised to the number of
+// opponents, as if their hands were independent.
+inline auto strength_of(const std::array<std::uint64_t, 3>& totals, int num_opponents) noexcept -> double {
+    const auto total = static_cast<double>(totals[ahead] + totals[tied] + totals[behind]);
+    const auto strength = (totals[ahead] + totals[tied] / 2.0) / total;
+    return std::pow(strength, num_opponents);
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// The hand strength (HS) of the hand on the current board: the share of the
+// pot it wins against 'num_opponents' random hands if no more cards came.
+// 'board' holds the flop, the turn or the river.
+inline auto hand_strength(const hole_cards& hc, span<const card> board, int num_opponents = 1) POKER_NOEXCEPT -> double {
+    POKER_DETAIL_ASSERT(num_opponents >= 1, "There must be an opponent");
+    const auto [hole, board_set] = detail::hole_and_board(hc, board);
+    const auto opponents = detail::opponent_hands{hole, board_set};
+    return detail::strength_of(opponents.totals(), num_opponents);
+}
+
+// The hand strength along with the positive and negative potential (PPot,
+// NPot) of the hand against a random hand, and the effective hand strength
+// (EHS) against 'num_opponents' random hands. The potentials play every
+// opponent hand out on every board to come, spread over 'num_threads'
+// threads. That takes well under a millisecond on the flop, so one thread is
+// the default. On the river there is no potential, and EHS is the hand
+// strength.
+inline auto effective_hand_strength(const hole_cards& hc, span<const card> board, int num_opponents = 1, unsigned num_threads = 1)
+    -> hand_strength_metrics
+{
+    POKER_DETAIL_ASSERT(num_opponents >= 1, "There must be an opponent");
+    using detail::ahead, detail::tied, detail::behind;
+    const auto [hole, board_set] = detail::hole_and_board(hc, board);
+    const auto opponents = detail::opponent_hands{hole, board_set};
+    auto result = hand_strength_metrics{};
+    result.strength = detail::strength_of(opponents.totals(), num_opponents);
+    result.effective_strength = result.strength;
+    if (board_set.size() == 5) return result;
+
+    // Boards to come are grouped by their ranks, which makes a task of every
+    // rank of the turn, or every pair of ranks of the turn and the river.
+    auto live_by_rank = std::array<card_set, 13>{};
+    for (auto i = 0; i < opponents.num_live(); ++i) {
+        const auto c = opponents.live(i);
+        live_by_rank[static_cast<int>((*c.begin()).rank)] |= c;
+    }
+    const auto to_come = 5 - board_set.size();
+    num_threads = detail::resolve_num_threads(num_threads);
+    auto counts = std::vector<detail::potential_counts>(num_threads);
+    detail::parallel_for(to_come == 1 ? 13 : detail::rank_pairs::size, num_threads, [&] (std::size_t task, unsigned worker) {
+        auto pairs = std::optional<detail::rank_pairs>{};
+        const auto add_board = [&] (card_set cards) {
+            if (!pairs) pairs = opponents.rank_pairs_of(cards);
+            opponents.add_board(cards, *pairs, hand_rank{detail::evaluate_7(hole | cards)}, counts[worker].counts);
+        };
+        if (to_come == 1) {
+            for (auto c : live_by_rank[task]) add_board(board_set | card_set{{&c, 1}});
+            return;
+        }
+        auto hi = 0;
+        while ((hi + 1) * (hi + 2) / 2 <= static_cast<int>(task)) ++hi;
+        const auto lo = static_cast<int>(task) - hi * (hi + 1) / 2;
+        for (auto x : live_by_rank[lo]) {
+            for (auto y : live_by_rank[hi]) {
+                if (lo == hi && to_card_index(y) <= to_card_index(x)) continue;
+                add_board(board_set | card_set{{&x, 1}} | card_set{{&y, 1}});
+            }
+        }
+    });
+    for (auto worker = 1u; worker < num_threads; ++worker) {
+        for (auto now = 0; now < 3; ++now) {
+            for (auto river = 0; river < 3; ++river) counts[0].counts[now][river] += counts[worker].counts[now][river];
+        }
+    }
+
+    const auto& hp = counts[0].counts;
+    const auto total = [&] (int now) { return static_cast<double>(hp[now][ahead] + hp[now][tied] + hp[now][behind]); };
+    const auto behind_or_tied = total(behind) + total(tied) / 2;
+    const auto ahead_or_tied = total(ahead) + total(tied) / 2;
+    if (behind_or_tied > 0) {
+        result.positive_potential = (hp[behind][ahead] + hp[behind][tied] / 2.0 + hp[tied][ahead] / 2.0) / behind_or_tied;
+    }
+    if (ahead_or_tied > 0) {
+        result.negative_potential = (hp[ahead][behind] + hp[ahead][tied] / 2.0 + hp[tied][behind] / 2.0) / ahead_or_tied;
+    }
+    result.effective_strength = result.strength * (1 - result.negative_potential) + (1 - result.strength) * result.positive_potential;
+    return result;
+}
+
+} // namespace poker
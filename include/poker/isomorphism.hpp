@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/span.hpp"
+
+// Relabelling the suits of a deal never changes how its hands compare, so
+// deals that only differ in their suits can be evaluated once. A suit's
+// signature is the masks of its ranks in each group of cards, the hole cards
+// and then the board. Sorting the suits by their signature, greatest first,
+// and relabelling them clubs, diamonds, hearts and spades in that order gives
+// every deal in a class the same representative.
+
+namespace poker::detail {
+
+struct suit_relabelling {
+    std::array<card_suit, 4> to;  // The new suit of each suit.
+    int multiplicity;             // Number of deals relabelled the same way.
+};
+
+// EXPECTS: 1 <= 'num_groups' <= 4
+constexpr auto canonical_relabelling(const card_set* groups, int num_groups) noexcept -> suit_relabelling {
+    auto signatures = std::array<std::uint64_t, 4>{};
+    auto order = std::array<int, 4>{0, 1, 2, 3};
+    for (auto s = 0; s < 4; ++s) {
+        for (auto g = 0; g < num_groups; ++g) {
+            signatures[s] = signatures[s] << 13 | groups[g].suit_mask(static_cast<card_suit>(s));
+        }
+    }
+    for (auto i = 1; i < 4; ++i) {
+        for (auto j = i; j > 0 && signatures[order[j]] > signatures[order[j - 1]]; --j) {
+            const auto t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    }
+    auto result = suit_relabelling{{}, 24};
+    auto run = 1;
+    for (auto i = 0; i < 4; ++i) {
+        result.to[order[i]] = static_cast<card_suit>(i);
+        // Suits with the same signature can be swapped without changing the
+        // deal, which leaves fewer distinct deals in the class.
+        if (i > 0 && signatures[order[i]] == signatures[order[i - 1]]) {
+            result.multiplicity /= ++run;
+        } else {
+            run = 1;
+        }
+    }
+    return result;
+}
+
+constexpr auto relabel(card_set cards, const std::array<card_suit, 4>& to) noexcept -> card_set {
+    auto bits = std::uint64_t{0};
+    for (auto s = 0; s < 4; ++s) {
+        bits |= std::uint64_t{cards.suit_mask(static_cast<card_suit>(s))} << 16 * static_cast<int>(to[s]);
+    }
+    return card_set::from_bits(bits);
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// The representative of the deals that only differ from a deal in their
+// suits.
+struct canonical_deal {
+    card_set hole;
+    card_set board;
+    std::array<card_suit, 4> suits;  // The suit each suit became.
+    int multiplicity;                // Number of distinct deals represented.
+};
+
+// The board is one unordered group of cards: deals whose flops and turns
+// differ but whose boards end up the same share a representative. Telling the
+// streets apart takes hand_indexer.
+constexpr auto canonicalize(card_set hole, card_set board) noexcept -> canonical_deal {
+    const card_set groups[] = {hole, board};
+    const auto r = detail::canonical_relabelling(groups, 2);
+    return {detail::relabel(hole, r.to), detail::relabel(board, r.to), r.to, r.multiplicity};
+}
+
+inline auto canonicalize(const hole_cards& hc, span<const card> board) POKER_NOEXCEPT -> canonical_deal {
+    auto hole = card_set{};
+    hole.insert(hc.first);
+    hole.insert(hc.second);
+    const auto board_set = card_set{board};
+    POKER_DETAIL_ASSERT(hole.size() == 2 && (hole & board_set).empty() && board_set.size() == static_cast<int>(board.size()),
+                        "Cards must not be used twice");
+    return canonicalize(hole, board_set);
+}
+
+// The representative of a board on its own, e.g. one of the 1755 flops.
+constexpr auto canonicalize(card_set board) noexcept -> canonical_deal {
+    return canonicalize(card_set{}, board);
+}
+
+// Relabels the suits of 'c' the way its deal was relabelled.
+constexpr auto relabel(card c, const canonical_deal& deal) noexcept -> card {
+    return card{c.rank, deal.suits[static_cast<int>(c.suit)]};
+}
+
+} // namespace poker
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <poker/card_set.hpp>
+#include "poker/detail/bit.hpp"
+#include "poker/detail/error.hpp"
+
+namespace poker::detail {
+
+// Moves the ace below the deuce: bit 0 is the ace, bit 7 the eight.
+constexpr auto ace_low_mask(unsigned rank_mask) noexcept -> unsigned {
+    return (rank_mask << 1 | rank_mask >> 12) & 0xff;
+}
+
+// EXPECTS: 'mask' is an ace-low mask of 5 ranks.
+// A low is as good as its highest card, then its next highest and so on, so
+// the smaller the mask the better the low.
+constexpr auto low_value(unsigned mask) noexcept -> std::uint16_t {
+    return static_cast<std::uint16_t>(0x100 - mask);
+}
+
+// The best eight-or-better low out of a mask of ranks, 0 if there is none.
+inline constexpr auto low_table = [] {
+    auto table = std::array<std::uint16_t, 8192>{};
+    for (auto mask = 0u; mask < table.size(); ++mask) {
+        auto low = ace_low_mask(mask);
+        if (popcount(low) < 5) continue;
+        while (popcount(low) > 5) low &= ~(1u << bit_floor_index(low));
+        table[mask] = low_value(low);
+    }
+    return table;
+}();
+
+} // namespace poker::detail
+
+namespace poker {
+
+// The strength of an eight-or-better low. Aces are low, straights and flushes
+// do not count against a low, and a better low has a greater rank. Hands
+// without five different ranks from the ace to the eight do not qualify and
+// have the rank 0.
+class low_rank {
+    std::uint16_t _value = 0;
+
+public:
+    constexpr low_rank() noexcept = default;
+
+    constexpr explicit low_rank(std::uint16_t value) noexcept
+        : _value{value}
+    {
+    }
+
+    constexpr auto value()     const noexcept -> std::uint16_t { return _value;      }
+    constexpr auto qualifies() const noexcept -> bool          { return _value != 0; }
+};
+
+constexpr auto operator==(low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() == rhs.value(); }
+constexpr auto operator!=(low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() != rhs.value(); }
+constexpr auto operator< (low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() <  rhs.value(); }
+constexpr auto operator> (low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() >  rhs.value(); }
+constexpr auto operator<=(low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() <= rhs.value(); }
+constexpr auto operator>=(low_rank lhs, low_rank rhs) noexcept -> bool { return lhs.value() >= rhs.value(); }
+
+// Evaluates the best low out of any number of cards, such as the seven cards
+// of a stud hand. Paired cards simply do not play.
+constexpr auto evaluate_low_rank(card_set cards) noexcept -> low_rank {
+    return low_rank{detail::low_table[cards.rank_mask()]};
+}
+
+} // namespace poker
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <poker/card_set.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/hand_ranking.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+
+// Lowball games award the pot to the worst high hand.
+//
+// Deuce-to-seven plays the ace high only, and straights and flushes count
+// against the hand, so a deuce-to-seven value is the standard value without
+// the A-2-3-4-5 straight, inverted.
+//
+// Ace-to-five plays the ace low and ignores straights and flushes. Its values
+// are the standard values of the ranks with the ace moved below the deuce and
+// without straights, inverted. Out of more than five cards the five making
+// the lowest hand play.
+
+namespace poker::detail::lowball {
+
+constexpr auto no_straight(unsigned) noexcept -> int {
+    return -1;
+}
+
+// The standard straights, except A-2-3-4-5.
+constexpr auto ace_high_straight(unsigned mask) noexcept -> int {
+    for (auto high = 12; high >= 4; --high) {
+        if ((mask >> (high - 4) & 0x1f) == 0x1f) return high;
+    }
+    return -1;
+}
+
+constexpr auto invert(hand_value value) noexcept -> std::uint16_t {
+    return static_cast<std::uint16_t>(0xffff - value);
+}
+
+constexpr auto ranking(std::uint16_t value) noexcept -> hand_ranking {
+    return hand_value_ranking(invert(value));
+}
+
+// The ace-to-five value of exactly five ranks.
+constexpr auto ace_to_five_value(const std::array<int, 13>& counts) noexcept -> std::uint16_t {
+    auto ace_low = std::array<int, 13>{};
+    ace_low[0] = counts[12];
+    for (auto r = 0; r < 12; ++r) ace_low[r + 1] = counts[r];
+    return invert(unsuited_hand_value(ace_low, no_straight));
+}
+
+class evaluator_tables {
+public:
+    static auto get() noexcept -> const evaluator_tables& {
+        static const auto tables = evaluator_tables{};
+        return tables;
+    }
+
+    // EXPECTS: 'mask' has 5 ranks.
+    auto deuce_to_seven_flush(unsigned mask) const noexcept -> std::uint16_t {
+        return _deuce_to_seven_flush[mask];
+    }
+
+    // EXPECTS: 'key' is the sum of the rank keys of 5 cards.
+    auto deuce_to_seven(std::uint32_t key) const noexcept -> std::uint16_t {
+        return _deuce_to_seven[key];
+    }
+
+    // EXPECTS: 'key' is the sum of the rank keys of 'num_cards' cards, 5 to 7.
+    auto ace_to_five(std::uint32_t key, int num_cards) const noexcept -> std::uint16_t {
+        return _ace_to_five[num_cards - 5][key];
+    }
+
+private:
+    evaluator_tables() {
+        for (auto mask = 0u; mask < _deuce_to_seven_flush.size(); ++mask) {
+            if (popcount(mask) == 5) _deuce_to_seven_flush[mask] = invert(flush_hand_value(mask, ace_high_straight));
+        }
+        auto entries = std::vector<std::pair<std::uint32_t, hand_value>>{};
+        for_each_rank_multiset(5, [&] (const auto& counts) {
+            entries.emplace_back(counts_key(counts), invert(unsuited_hand_value(counts, ace_high_straight)));
+        });
+        _deuce_to_seven = displaced_table{entries};
+        entries.clear();
+        for_each_rank_multiset(5, [&] (const auto& counts) {
+            entries.emplace_back(counts_key(counts), ace_to_five_value(counts));
+        });
+        _ace_to_five[0] = displaced_table{entries};
+        // The best five of six or seven cards are the best five of the
+        // hands left by leaving one card out.
+        for (auto num_cards = 6; num_cards <= 7; ++num_cards) {
+            entries.clear();
+            const auto& fewer = _ace_to_five[num_cards - 6];
+            for_each_rank_multiset(num_cards, [&] (const auto& counts) {
+                const auto key = counts_key(counts);
+                auto best = hand_value{0};
+                for (auto r = 0; r < 13; ++r) {
+                    if (counts[r] != 0) best = std::max(best, fewer[key - rank_keys[r]]);
+                }
+                entries.emplace_back(key, best);
+            });
+            _ace_to_five[num_cards - 5] = displaced_table{entries};
+        }
+    }
+
+    std::array<std::uint16_t, 8192> _deuce_to_seven_flush = {};
+    displaced_table _deuce_to_seven;
+    std::array<displaced_table, 3> _ace_to_five;
+};
+
+} // namespace poker::detail::lowball
+
+namespace poker {
+
+// Deuce-to-seven lowball hands: five cards, ace high, straights and flushes
+// count. The best hand is 7-5-4-3-2 in more than one suit.
+struct deuce_to_seven_rules {
+    static auto evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t;
+
+    static constexpr auto ranking(std::uint16_t value) noexcept -> hand_ranking {
+        return detail::lowball::ranking(value);
+    }
+};
+
+// Ace-to-five lowball hands: the best five of five to seven cards, ace low,
+// straights and flushes do not count. The best hand is A-2-3-4-5.
+struct ace_to_five_rules {
+    static auto evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t;
+
+    static constexpr auto ranking(std::uint16_t value) noexcept -> hand_ranking {
+        return detail::lowball::ranking(value);
+    }
+};
+
+using deuce_to_seven_rank = basic_hand_rank<deuce_to_seven_rules>;
+using ace_to_five_rank = basic_hand_rank<ace_to_five_rules>;
+
+inline auto evaluate_deuce_to_seven_rank(card_set cards) POKER_NOEXCEPT -> deuce_to_seven_rank {
+    POKER_DETAIL_ASSERT(cards.size() == 5, "Exactly five cards must be evaluated");
+    const auto& tables = detail::lowball::evaluator_tables::get();
+    if (const auto flush = detail::flush_suits(cards); flush != 0) {
+        return deuce_to_seven_rank{tables.deuce_to_seven_flush(detail::flush_mask(cards, flush))};
+    }
+    return deuce_to_seven_rank{tables.deuce_to_seven(detail::rank_key(cards))};
+}
+
+inline auto evaluate_ace_to_five_rank(card_set cards) POKER_NOEXCEPT -> ace_to_five_rank {
+    POKER_DETAIL_ASSERT(cards.size() >= 5 && cards.size() <= 7, "Five, six or seven cards must be evaluated");
+    const auto& tables = detail::lowball::evaluator_tables::get();
+    return ace_to_five_rank{tables.ace_to_five(detail::rank_key(cards), cards.size())};
+}
+
+inline auto deuce_to_seven_rules::evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t {
+    return evaluate_deuce_to_seven_rank(cards).value();
+}
+
+inline auto ace_to_five_rules::evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t {
+    return evaluate_ace_to_five_rank(cards).value();
+}
+
+} // namespace poker
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/low_rank.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/span.hpp"
+
+namespace poker::detail {
+
+// Appends 'key' to the first 'size' keys unless it is there already.
+template<std::size_t N>
+inline void insert_unique(std::array<std::uint32_t, N>& keys, int& size, std::uint32_t key) noexcept {
+    if (std::find(keys.begin(), keys.begin() + size, key) == keys.begin() + size) keys[size++] = key;
+}
+
+// EXPECTS: 4 or 5 hole cards, 3 to 5 community cards.
+inline auto evaluate_omaha(span<const card> hole, span<const card> board) noexcept -> hand_value {
+    const auto& tables = evaluator_tables::get();
+    const auto hole_set = card_set{hole};
+    const auto board_set = card_set{board};
+
+    // A flush takes two hole cards and three community cards of one suit.
+    auto best = hand_value{0};
+    for (auto suit = 0; suit < 4; ++suit) {
+        const auto h = hole_set.suit_mask(static_cast<card_suit>(suit));
+        const auto b = board_set.suit_mask(static_cast<card_suit>(suit));
+        if (popcount(h) < 2 || popcount(b) < 3) continue;
+        for (auto x = h; x != 0; x &= x - 1) {
+            for (auto y = x & (x - 1); y != 0; y &= y - 1) {
+                const auto two = lowest_bit(x) | lowest_bit(y);
+                for (auto u = b; u != 0; u &= u - 1) {
+                    for (auto v = u & (u - 1); v != 0; v &= v - 1) {
+                        for (auto w = v & (v - 1); w != 0; w &= w - 1) {
+                            best = std::max(best, tables.flush(two | lowest_bit(u) | lowest_bit(v) | lowest_bit(w)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // Three different ranks from the board and two from the hand make two pair
+    // at most, so nothing beats a flush unless the board is paired.
+    if (best != 0 && popcount(board_set.rank_mask()) == static_cast<int>(board.size())) return best;
+
+    // Everything else only depends on the ranks, so each distinct rank pair in
+    // the hand is combined with each distinct rank triple on the board once.
+    auto pairs = std::array<std::uint32_t, 10>{};
+    auto num_pairs = 0;
+    for (auto i = std::size_t{0}; i < hole.size(); ++i) {
+        for (auto j = i + 1; j < hole.size(); ++j) {
+            insert_unique(pairs, num_pairs, rank_keys[to_underlying(hole[i].rank)] + rank_keys[to_underlying(hole[j].rank)]);
+        }
+    }
+    auto triples = std::array<std::uint32_t, 10>{};
+    auto num_triples = 0;
+    for (auto i = std::size_t{0}; i < board.size(); ++i) {
+        for (auto j = i + 1; j < board.size(); ++j) {
+            for (auto k = j + 1; k < board.size(); ++k) {
+                insert_unique(triples, num_triples, rank_keys[to_underlying(board[i].rank)]
+                                                  + rank_keys[to_underlying(board[j].rank)]
+                                                  + rank_keys[to_underlying(board[k].rank)]);
+            }
+        }
+    }
+    for (auto i = 0; i < num_pairs; ++i) {
+        for (auto j = 0; j < num_triples; ++j) {
+            best = std::max(best, tables.unsuited_5(pairs[i] + triples[j]));
+        }
+    }
+    return best;
+}
+
+// EXPECTS: 4 or 5 hole cards, 3 to 5 community cards.
+inline auto evaluate_omaha_low(span<const card> hole, span<const card> board) noexcept -> std::uint16_t {
+    // Paired cards cannot play in a low, so only the distinct ranks matter.
+    const auto h = ace_low_mask(card_set{hole}.rank_mask());
+    const auto b = ace_low_mask(card_set{board}.rank_mask());
+    auto best = std::uint16_t{0};
+    for (auto x = h; x != 0; x &= x - 1) {
+        for (auto y = x & (x - 1); y != 0; y &= y - 1) {
+            const auto two = lowest_bit(x) | lowest_bit(y);
+            for (auto u = b & ~two; u != 0; u &= u - 1) {
+                for (auto v = u & (u - 1); v != 0; v &= v - 1) {
+                    for (auto w = v & (v - 1); w != 0; w &= w - 1) {
+                        best = std::max(best, low_value(two | lowest_bit(u) | lowest_bit(v) | lowest_bit(w)));
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// Evaluates an Omaha hand, made of exactly two of the hole cards and three of
+// the community cards. Takes four hole cards, or five for 5-card Omaha, and
+// the flop, the turn or the river. Ranks are on the same scale as the ranks
+// returned by evaluate_rank().
+inline auto evaluate_omaha_rank(span<const card> hole, span<const card> board) POKER_NOEXCEPT -> hand_rank {
+    POKER_DETAIL_ASSERT(hole.size() == 4 || hole.size() == 5, "Omaha is played with four or five hole cards");
+    POKER_DETAIL_ASSERT(board.size() >= 3 && board.size() <= 5, "The flop must be dealt");
+    return hand_rank{detail::evaluate_omaha(hole, board)};
+}
+
+// Evaluates the eight-or-better low of an Omaha Hi-Lo hand, made of exactly
+// two of the hole cards and three of the community cards.
+inline auto evaluate_omaha_low_rank(span<const card> hole, span<const card> board) POKER_NOEXCEPT -> low_rank {
+    POKER_DETAIL_ASSERT(hole.size() == 4 || hole.size() == 5, "Omaha is played with four or five hole cards");
+    POKER_DETAIL_ASSERT(board.size() >= 3 && board.size() <= 5, "The flop must be dealt");
+    return low_rank{detail::evaluate_omaha_low(hole, board)};
+}
+
+} // namespace poker
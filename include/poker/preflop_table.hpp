@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/equity.hpp>
+#include <poker/hole_cards.hpp>
+#include <poker/range.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/mapped_file.hpp"
+#include "poker/detail/parallel.hpp"
+
+namespace poker::detail {
+
+// Index of the unordered pair of combos 'i < j'. Pairs are numbered the way
+// combos number pairs of cards.
+constexpr auto combo_pair_index(std::size_t i, std::size_t j) noexcept -> std::size_t {
+    return j * (j - 1) / 2 + i;
+}
+
+constexpr auto num_combo_pairs = combo_pair_index(0, num_combos);
+
+// The 24 ways of relabelling the suits.
+constexpr auto suit_permutations = [] {
+    auto result = std::array<std::array<int, 4>, 24>{};
+    auto p = std::array<int, 4>{0, 1, 2, 3};
+    for (auto& perm : result) {
+        perm = p;
+        // Next permutation in lexicographic order.
+        auto i = 2;
+        while (i >= 0 && p[i] > p[i + 1]) --i;
+        if (i < 0) break;
+        auto j = 3;
+        while (p[j] < p[i]) --j;
+        const auto t = p[i]; p[i] = p[j]; p[j] = t;
+        for (auto l = i + 1, r = 3; l < r; ++l, --r) {
+            const auto u = p[l]; p[l] = p[r]; p[r] = u;
+        }
+    }
+    return result;
+}();
+
+constexpr auto permute_suits(card c, const std::array<int, 4>& perm) noexcept -> card {
+    return card{c.rank, static_cast<card_suit>(perm[static_cast<int>(c.suit)])};
+}
+
+constexpr auto permute_suits(const hole_cards& hc, const std::array<int, 4>& perm) noexcept -> hole_cards {
+    return hole_cards{permute_suits(hc.first, perm), permute_suits(hc.second, perm)};
+}
+
+} // namespace poker::detail
+
+namespace poker {
+
+// The all-in equity of every heads-up preflop matchup, looked up in constant
+// time.
+//
+// Only the matchups that are the least under a relabelling of the suits are
+// played out; the others share their equity. The table holds the equity of
+// the lower of each pair of combos in 65535ths, so it is under 2 MB. It can
+// be saved to a file and mapped back into memory instead of being rebuilt,
+// which takes a long time.
+class preflop_equity_table {
+public:
+    preflop_equity_table(preflop_equity_table&&) = default;
+    auto operator=(preflop_equity_table&&) -> preflop_equity_table& = default;
+
+    // Plays out every matchup on all of the boards, on 'num_threads' threads.
+    // It takes on the order of an hour of CPU time, so the table is best
+    // built offline with the poker-preflop-table tool and loaded.
+    static auto build(unsigned num_threads = 0) -> preflop_equity_table;
+
+    // Builds the table from 'equity_of(first, second)', the equity of 'first'
+    // against 'second', called once per matchup up to suits.
+    template<class F>
+    static auto build(F equity_of, unsigned num_threads) -> preflop_equity_table;
+
+    // Returns std::nullopt if the file cannot be read or does not hold a table.
+    static auto load(const char* path) -> std::optional<preflop_equity_table>;
+
+    auto save(const char* path) const -> bool;
+
+    // The equity of 'first' against 'second'.
+    auto equity(const hole_cards& first, const hole_cards& second) const POKER_NOEXCEPT -> double;
+
+private:
+    static constexpr auto magic = std::uint32_t{0x46504b50}; // "PKPF"
+    static constexpr auto version = std::uint32_t{1};
+    static constexpr auto header_size = std::size_t{16}; // Bytes.
+    // Padded to a whole number of 32-bit words.
+    static constexpr auto num_equities = (detail::num_combo_pairs + 1) / 2 * 2;
+    static constexpr auto file_size = header_size + num_equities * sizeof(std::uint16_t);
+    static constexpr auto scale = 65535.0;
+
+    preflop_equity_table() = default;
+
+    explicit preflop_equity_table(detail::mapped_file file) noexcept;
+
+    std::vector<std::uint16_t> _image; // The equities of a built table.
+    detail::mapped_file _file;
+    const std::uint16_t* _equities = nullptr;
+};
+
+inline auto preflop_equity_table::build(unsigned num_threads) -> preflop_equity_table {
+    return build([] (const hole_cards& first, const hole_cards& second) {
+        const hole_cards players[] = {first, second};
+        return exhaustive_equity(players, {}, 1)[0].equity;
+    }, num_threads);
+}
+
+template<class F>
+inline auto preflop_equity_table::build(F equity_of, unsigned num_threads) -> preflop_equity_table {
+    auto result = preflop_equity_table{};
+    result._image.resize(num_equities);
+    const auto equities = result._image.data();
+
+    // For every matchup, the least matchup it maps to under a relabelling of
+    // the suits, and whether its combos swap places on the way. Pairs of
+    // combos sharing a card are not matchups.
+    constexpr auto no_matchup = std::uint32_t{0xffffffff};
+    auto classes = std::vector<std::uint32_t>(detail::num_combo_pairs, no_matchup);
+    auto tasks = std::vector<std::uint32_t>{};
+    for (auto j = std::size_t{1}; j < num_combos; ++j) {
+        const auto second = combo_cards(j);
+        for (auto i = std::size_t{0}; i < j; ++i) {
+            if (!(combo_set(i) & combo_set(j)).empty()) continue;
+            const auto first = combo_cards(i);
+            auto least = detail::num_combo_pairs;
+            auto swapped = false;
+            for (const auto& perm : detail::suit_permutations) {
+                const auto x = combo_index(detail::permute_suits(first, perm));
+                const auto y = combo_index(detail::permute_suits(second, perm));
+                const auto pair = x < y ? detail::combo_pair_index(x, y) : detail::combo_pair_index(y, x);
+                if (pair < least) {
+                    least = pair;
+                    swapped = x > y;
+                }
+            }
+            const auto pair = detail::combo_pair_index(i, j);
+            classes[pair] = static_cast<std::uint32_t>(least << 1 | swapped);
+            if (least == pair) tasks.push_back(static_cast<std::uint32_t>(pair));
+        }
+    }
+
+    detail::parallel_for(tasks.size(), num_threads, [&] (std::size_t t, unsigned) {
+        auto j = std::size_t{1};
+        while (detail::combo_pair_index(0, j + 1) <= tasks[t]) ++j;
+        const auto i = tasks[t] - detail::combo_pair_index(0, j);
+        const auto equity = static_cast<double>(equity_of(combo_cards(i), combo_cards(j)));
+        equities[tasks[t]] = static_cast<std::uint16_t>(std::lround(equity * scale));
+    });
+    for (auto pair = std::size_t{0}; pair < detail::num_combo_pairs; ++pair) {
+        const auto least = classes[pair] >> 1;
+        if (classes[pair] == no_matchup || least == pair) continue;
+        const auto equity = equities[least];
+        equities[pair] = static_cast<std::uint16_t>(classes[pair] & 1 ? scale - equity : equity);
+    }
+
+    result._equities = equities;
+    return result;
+}
+
+inline preflop_equity_table::preflop_equity_table(detail::mapped_file file) noexcept
+    : _file{std::move(file)}
+    , _equities{reinterpret_cast<const std::uint16_t*>(_file.data() + header_size)}
+{
+}
+
+inline auto preflop_equity_table::load(const char* path) -> std::optional<preflop_equity_table> {
+    auto file = detail::mapped_file::open(path);
+    if (!file || file->size() != file_size) return std::nullopt;
+    std::uint32_t header[4];
+    std::memcpy(header, file->data(), header_size);
+    if (header[0] != magic || header[1] != version || header[2] != num_combos) return std::nullopt;
+    return preflop_equity_table{std::move(*file)};
+}
+
+inline auto preflop_equity_table::save(const char* path) const -> bool {
+    const std::uint32_t header[4] = {magic, version, static_cast<std::uint32_t>(num_combos), 0};
+    auto out = std::ofstream{path, std::ios::binary};
+    out.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(header_size));
+    out.write(reinterpret_cast<const char*>(_equities), static_cast<std::streamsize>(num_equities * sizeof(std::uint16_t)));
+    return static_cast<bool>(out);
+}
+
+inline auto preflop_equity_table::equity(const hole_cards& first, const hole_cards& second) const POKER_NOEXCEPT -> double {
+    const auto i = combo_index(first);
+    const auto j = combo_index(second);
+    POKER_DETAIL_ASSERT((combo_set(i) & combo_set(j)).empty(), "Cards must not be used twice");
+    if (i < j) return _equities[detail::combo_pair_index(i, j)] / scale;
+    return 1 - _equities[detail::combo_pair_index(j, i)] / scale;
+}
+
+} // namespace poker
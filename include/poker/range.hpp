@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/error.hpp"
+
+namespace poker {
+
+// There are 1326 two-card combos. Combo 'j * (j - 1) / 2 + i' holds the cards
+// with indices 'i < j'.
+constexpr auto num_combos = std::size_t{1326};
+
+// EXPECTS: The hole cards are distinct.
+constexpr auto combo_index(const hole_cards& hc) noexcept -> std::size_t {
+    auto i = static_cast<std::size_t>(to_card_index(hc.first));
+    auto j = static_cast<std::size_t>(to_card_index(hc.second));
+    if (i > j) {
+        const auto t = i;
+        i = j;
+        j = t;
+    }
+    return j * (j - 1) / 2 + i;
+}
+
+// Returns the hole cards of combo 'index', lower card index first.
+constexpr auto combo_cards(std::size_t index) noexcept -> hole_cards {
+    auto j = std::size_t{1};
+    while ((j + 1) * j / 2 <= index) ++j;
+    const auto i = index - j * (j - 1) / 2;
+    return {to_card(static_cast<card_index>(i)), to_card(static_cast<card_index>(j))};
+}
+
+constexpr auto combo_set(std::size_t index) noexcept -> card_set {
+    const auto hc = combo_cards(index);
+    auto result = card_set{};
+    result.insert(hc.first);
+    result.insert(hc.second);
+    return result;
+}
+
+// A weight for each of the 1326 combos. A combo's weight is the relative
+// frequency with which the player holds it; combos weighted 0 are out of the
+// range.
+class hand_range {
+public:
+    hand_range() noexcept = default;
+
+    auto weight(std::size_t combo) const POKER_NOEXCEPT -> double {
+        POKER_DETAIL_ASSERT(combo < num_combos, "Invalid combo index");
+        return _weights[combo];
+    }
+
+    auto weight(const hole_cards& hc) const POKER_NOEXCEPT -> double {
+        return weight(combo_index(hc));
+    }
+
+    void set_weight(std::size_t combo, double weight) POKER_NOEXCEPT {
+        POKER_DETAIL_ASSERT(combo < num_combos, "Invalid combo index");
+        POKER_DETAIL_ASSERT(weight >= 0, "Weights must not be negative");
+        _weights[combo] = weight;
+    }
+
+    void set_weight(const hole_cards& hc, double weight) POKER_NOEXCEPT {
+        set_weight(combo_index(hc), weight);
+    }
+
+    auto weights() const noexcept -> const std::array<double, num_combos>& {
+        return _weights;
+    }
+
+private:
+    std::array<double, num_combos> _weights = {};
+};
+
+} // namespace poker
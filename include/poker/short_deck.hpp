@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/community_cards.hpp>
+#include <poker/deck.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/hand_ranking.hpp>
+#include <poker/hole_cards.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/span.hpp"
+#include "poker/detail/utility.hpp"
+
+// Short-deck (6+) Hold'em is played without the deuces through fives. The
+// ace also plays low in A-6-7-8-9, and a flush beats a full house.
+//
+// Hand values use the layout of the standard ones, with the rankings of flush
+// and full house swapped in the top 4 bits.
+
+namespace poker::detail::short_deck {
+
+constexpr auto lowest_rank = int{to_underlying(card_rank::_6)};
+
+// The cards of the ranks missing from the deck.
+constexpr auto missing_cards = std::uint64_t{0x000f000f000f000f};
+
+// The cards in the deck, suit by suit, rank by rank.
+inline constexpr auto card_indices = [] {
+    auto cards = std::array<card_index, 36>{};
+    auto i = std::size_t{0};
+    for (auto suit = 0; suit < 4; ++suit) {
+        for (auto rank = lowest_rank; rank < 13; ++rank) {
+            cards[i++] = to_card_index(card{static_cast<card_rank>(rank), static_cast<card_suit>(suit)});
+        }
+    }
+    return cards;
+}();
+
+constexpr auto straight_high_rank(unsigned mask) noexcept -> int {
+    for (auto high = 12; high >= lowest_rank + 4; --high) {
+        if ((mask >> (high - 4) & 0x1f) == 0x1f) return high;
+    }
+    if ((mask & 0x10f0) == 0x10f0) return lowest_rank + 3; // A-6-7-8-9
+    return -1;
+}
+
+// Turns a value built with the standard rankings into a short-deck value.
+constexpr auto from_standard(hand_value value) noexcept -> hand_value {
+    switch (hand_value_ranking(value)) {
+    case hand_ranking::flush:      return make_hand_value(hand_ranking::full_house, hand_value_index(value));
+    case hand_ranking::full_house: return make_hand_value(hand_ranking::flush, hand_value_index(value));
+    default:                       return value;
+    }
+}
+
+constexpr auto ranking(hand_value value) noexcept -> hand_ranking {
+    return hand_value_ranking(from_standard(value));
+}
+
+class evaluator_tables {
+public:
+    static auto get() noexcept -> const evaluator_tables& {
+        static const auto tables = evaluator_tables{};
+        return tables;
+    }
+
+    // EXPECTS: 'mask' has at least 5 ranks, none lower than a six.
+    auto flush(unsigned mask) const noexcept -> hand_value {
+        return _flush[mask >> lowest_rank];
+    }
+
+    // EXPECTS: 'key' is the sum of the rank keys of 7 cards.
+    auto unsuited_7(std::uint32_t key) const noexcept -> hand_value {
+        return _unsuited_7[key];
+    }
+
+    // Sum of the rank keys of the ranks in 'mask'.
+    auto rank_key(unsigned mask) const noexcept -> std::uint32_t {
+        return _rank_keys[mask >> lowest_rank];
+    }
+
+private:
+    static constexpr auto num_ranks = 13 - lowest_rank;
+
+    evaluator_tables() {
+        for (auto bits = 0u; bits < _flush.size(); ++bits) {
+            const auto mask = bits << lowest_rank;
+            if (popcount(mask) >= 5) _flush[bits] = from_standard(flush_hand_value(mask, straight_high_rank));
+            for (auto r = lowest_rank; r < 13; ++r) {
+                if (mask >> r & 1) _rank_keys[bits] += rank_keys[r];
+            }
+        }
+
+        auto entries = std::vector<std::pair<std::uint32_t, hand_value>>{};
+        for_each_rank_multiset(7, [&] (const auto& counts) {
+            entries.emplace_back(counts_key(counts), from_standard(unsuited_hand_value(counts, straight_high_rank)));
+        }, lowest_rank);
+        _unsuited_7 = displaced_table{entries};
+    }
+
+    std::array<hand_value, 1 << num_ranks> _flush = {};
+    std::array<std::uint32_t, 1 << num_ranks> _rank_keys = {};
+    displaced_table _unsuited_7;
+};
+
+// EXPECTS: 'cards' holds 7 cards, none lower than a six.
+inline auto evaluate_7(card_set cards) noexcept -> hand_value {
+    const auto& tables = evaluator_tables::get();
+    if (const auto flush = flush_suits(cards); flush != 0) return tables.flush(flush_mask(cards, flush));
+    return tables.unsuited_7(tables.rank_key(cards.suit_mask(card_suit::clubs))
+                           + tables.rank_key(cards.suit_mask(card_suit::diamonds))
+                           + tables.rank_key(cards.suit_mask(card_suit::hearts))
+                           + tables.rank_key(cards.suit_mask(card_suit::spades)));
+}
+
+} // namespace poker::detail::short_deck
+
+namespace poker::short_deck {
+
+// Short-deck hands, ranked with a flush above a full house.
+struct rules {
+    static auto evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t;
+
+    static constexpr auto ranking(std::uint16_t value) noexcept -> hand_ranking {
+        return detail::short_deck::ranking(value);
+    }
+};
+
+using hand_rank = basic_hand_rank<rules>;
+
+inline auto evaluate_rank(card_set cards) POKER_NOEXCEPT -> hand_rank {
+    POKER_DETAIL_ASSERT(cards.size() == 7, "Exactly seven cards must be evaluated");
+    POKER_DETAIL_ASSERT((cards.bits() & detail::short_deck::missing_cards) == 0, "The short deck has no cards lower than a six");
+    return hand_rank{detail::short_deck::evaluate_7(cards)};
+}
+
+// Qualified calls: card_set arguments would find poker::evaluate_rank() too.
+inline auto evaluate_rank(span<const card> cards) POKER_NOEXCEPT -> hand_rank {
+    return short_deck::evaluate_rank(card_set{cards});
+}
+
+inline auto evaluate_rank(const hole_cards& hc, const community_cards& cc) POKER_NOEXCEPT -> hand_rank {
+    POKER_DETAIL_ASSERT(cc.cards().size() == 5, "All community cards must be dealt");
+    auto cards = card_set{cc.cards()};
+    cards.insert(hc.first);
+    cards.insert(hc.second);
+    return short_deck::evaluate_rank(cards);
+}
+
+inline auto rules::evaluate(card_set cards) POKER_NOEXCEPT -> std::uint16_t {
+    return short_deck::evaluate_rank(cards).value();
+}
+
+// The 36 cards from the sixes up, shuffled as they are drawn like
+// poker::deck.
+using deck = detail::basic_deck<detail::short_deck::card_indices>;
+
+} // namespace poker::short_deck
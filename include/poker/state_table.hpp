@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <poker/card.hpp>
+#include <poker/card_set.hpp>
+#include <poker/hand_rank.hpp>
+#include "poker/detail/error.hpp"
+#include "poker/detail/hand_evaluator.hpp"
+#include "poker/detail/mapped_file.hpp"
+
+namespace poker {
+
+// The cards added to a state_table so far.
+class evaluator_state {
+    std::uint32_t _node = 0;
+    card_set _cards;
+
+    friend class state_table;
+
+public:
+    auto cards() const noexcept -> card_set { return _cards; }
+};
+
+// Evaluates a hand one card at a time, so that nested loops over the cards
+// still to come only pay for the cards they add.
+//
+// Every multiset of up to 6 ranks is a node with a transition per rank. The
+// transitions of the nodes of 6 ranks lead straight to the hand value of the
+// 7 ranks, so evaluating the ranks takes one load per card. Flushes are
+// looked up once all 7 cards are in, by the suits of the cards in the state.
+//
+// Building the table takes tens of milliseconds. It can be saved to a file and
+// mapped back into memory instead.
+class state_table {
+public:
+    state_table();
+
+    state_table(state_table&&) = default;
+    auto operator=(state_table&&) -> state_table& = default;
+
+    // Returns std::nullopt if the file cannot be read or does not hold a table.
+    static auto load(const char* path) -> std::optional<state_table>;
+
+    auto save(const char* path) const -> bool;
+
+    auto start() const noexcept -> evaluator_state { return evaluator_state{}; }
+
+    auto advance(evaluator_state state, card c) const POKER_NOEXCEPT -> evaluator_state;
+
+    auto rank(evaluator_state state) const POKER_NOEXCEPT -> hand_rank;
+
+private:
+    static constexpr auto magic = std::uint32_t{0x54534b50}; // "PKST"
+    static constexpr auto version = std::uint32_t{1};
+    static constexpr auto header_size = std::size_t{4};
+    static constexpr auto flush_size = std::size_t{8192};
+
+    state_table(detail::mapped_file file, std::size_t num_words) noexcept;
+
+    void set_sections() noexcept;
+
+    std::vector<std::uint32_t> _image;
+    detail::mapped_file _file;
+    const std::uint32_t* _words = nullptr;
+    std::size_t _num_words = 0;
+    const std::uint32_t* _flush = nullptr;
+    const std::uint32_t* _transitions = nullptr;
+};
+
+inline state_table::state_table() {
+    // Number the rank multisets by size, coding each one as a base-5 number
+    // with one digit per rank.
+    constexpr auto powers_of_5 = [] {
+        auto table = std::array<std::uint32_t, 13>{};
+        table[0] = 1;
+        for (auto r = 1; r < 13; ++r) table[r] = table[r-1] * 5;
+        return table;
+    }();
+    auto codes = std::vector<std::uint32_t>{0};
+    auto ids = std::unordered_map<std::uint32_t, std::uint32_t>{{0, 0}};
+    auto level_begin = std::size_t{0};
+    auto level_end = std::size_t{1};
+    for (auto size = 0; size < 6; ++size) {
+        for (auto node = level_begin; node < level_end; ++node) {
+            for (auto r = 0; r < 13; ++r) {
+                if (codes[node] / powers_of_5[r] % 5 == 4) continue;
+                const auto next = codes[node] + powers_of_5[r];
+                if (ids.emplace(next, static_cast<std::uint32_t>(codes.size())).second) codes.push_back(next);
+            }
+        }
+        level_begin = level_end;
+        level_end = codes.size();
+    }
+
+    _image.resize(header_size + flush_size + codes.size() * 13);
+    _image[0] = magic;
+    _image[1] = version;
+    _image[2] = static_cast<std::uint32_t>(codes.size());
+    for (auto mask = 0u; mask < flush_size; ++mask) {
+        if (detail::popcount(mask) >= 5) _image[header_size + mask] = detail::flush_hand_value(mask);
+    }
+    const auto transitions = _image.data() + header_size + flush_size;
+    for (auto node = std::size_t{0}; node < codes.size(); ++node) {
+        for (auto r = 0; r < 13; ++r) {
+            if (codes[node] / powers_of_5[r] % 5 == 4) continue;
+            const auto next = codes[node] + powers_of_5[r];
+            if (node < level_begin) {
+                transitions[node * 13 + r] = ids[next];
+            } else {
+                auto counts = std::array<int, 13>{};
+                for (auto i = 0; i < 13; ++i) counts[i] = static_cast<int>(next / powers_of_5[i] % 5);
+                transitions[node * 13 + r] = detail::unsuited_hand_value(counts);
+            }
+        }
+    }
+    _words = _image.data();
+    _num_words = _image.size();
+    set_sections();
+}
+
+inline state_table::state_table(detail::mapped_file file, std::size_t num_words) noexcept
+    : _file{std::move(file)}
+    , _words{reinterpret_cast<const std::uint32_t*>(_file.data())}
+    , _num_words{num_words}
+{
+    set_sections();
+}
+
+inline void state_table::set_sections() noexcept {
+    _flush = _words + header_size;
+    _transitions = _words + header_size + flush_size;
+}
+
+inline auto state_table::load(const char* path) -> std::optional<state_table> {
+    auto file = detail::mapped_file::open(path);
+    if (!file || file->size() % 4 != 0 || file->size() / 4 < header_size + flush_size) return std::nullopt;
+    const auto words = reinterpret_cast<const std::uint32_t*>(file->data());
+    const auto num_words = file->size() / 4;
+    if (words[0] != magic || words[1] != version || num_words != header_size + flush_size + words[2] * std::size_t{13}) {
+        return std::nullopt;
+    }
+    return state_table{std::move(*file), num_words};
+}
+
+inline auto state_table::save(const char* path) const -> bool {
+    auto out = std::ofstream{path, std::ios::binary};
+    out.write(reinterpret_cast<const char*>(_words), static_cast<std::streamsize>(_num_words * 4));
+    return static_cast<bool>(out);
+}
+
+inline auto state_table::advance(evaluator_state state, card c) const POKER_NOEXCEPT -> evaluator_state {
+    POKER_DETAIL_ASSERT(state._cards.size() < 7, "No more than seven cards can be evaluated");
+    POKER_DETAIL_ASSERT(!state._cards.contains(c), "A card cannot be added twice");
+    state._node = _transitions[state._node * 13 + static_cast<int>(c.rank)];
+    state._cards.insert(c);
+    return state;
+}
+
+inline auto state_table::rank(evaluator_state state) const POKER_NOEXCEPT -> hand_rank {
+    POKER_DETAIL_ASSERT(state._cards.size() == 7, "Exactly seven cards must be evaluated");
+    // A flush never comes with a full house or four of a kind in 7 cards, so
+    // it is the best hand whenever there is one.
+    if (const auto flush = detail::flush_suits(state._cards); flush != 0) {
+        return hand_rank{static_cast<std::uint16_t>(_flush[detail::flush_mask(state._cards, flush)])};
+    }
+    return hand_rank{static_cast<std::uint16_t>(state._node)};
+}
+
+} // namespace poker
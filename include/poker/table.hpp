@@ -277,7 +277,9 @@ inline void table::start_hand(URBG&& g) POKER_NOEXCEPT {
     _automatic_actions = {};
     _hand_players = _table_players;
     increment_button();
-    _deck = {std::forward<URBG>(g)};
+    // Only the cards the hand can deal are shuffled, with 'g' itself.
+    const auto num_players = std::count(_hand_players.occupancy().begin(), _hand_players.occupancy().end(), true);
+    _deck.fill_and_shuffle_first(g, static_cast<std::size_t>(2 * num_players + 5));
     _community_cards = {};
     new (&_dealer) dealer{_hand_players, _button, _forced_bets, _deck, _community_cards};
     _dealer.start_hand();
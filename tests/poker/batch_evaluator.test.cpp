@@ -0,0 +1,46 @@
+#include <doctest/doctest.h>
+
+#include <random>
+#include <vector>
+
+#include <poker/batch_evaluator.hpp>
+#include <poker/deck.hpp>
+
+using namespace poker;
+
+namespace {
+
+auto random_hands(std::size_t n) -> std::vector<card_set> {
+    auto g = std::mt19937{7};
+    auto hands = std::vector<card_set>(n);
+    for (auto& h : hands) {
+        auto d = deck{g};
+        for (auto i = 0; i < 7; ++i) h.insert(d.draw());
+    }
+    return hands;
+}
+
+} // namespace
+
+TEST_CASE("Batch evaluation matches evaluate_rank") {
+    // Not a multiple of the vector width, so the scalar tail is exercised.
+    const auto hands = random_hands(10003);
+    auto ranks = std::vector<hand_rank>(hands.size());
+    evaluate_batch(hands, ranks);
+    for (auto i = std::size_t{0}; i < hands.size(); ++i) {
+        REQUIRE_EQ(ranks[i], evaluate_rank(hands[i]));
+    }
+
+    SUBCASE("every kernel agrees") {
+        auto scalar = std::vector<hand_rank>(hands.size());
+        detail::evaluate_batch_scalar(hands.data(), scalar.data(), hands.size());
+        REQUIRE(scalar == ranks);
+#if POKER_DETAIL_HAS_AVX2_KERNEL
+        if (detail::cpu_supports_avx2()) {
+            auto vectorized = std::vector<hand_rank>(hands.size());
+            detail::evaluate_batch_avx2(hands.data(), vectorized.data(), hands.size());
+            REQUIRE(vectorized == ranks);
+        }
+#endif
+    }
+}
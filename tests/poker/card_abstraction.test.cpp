@@ -0,0 +1,124 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+#include <poker/card_abstraction.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+// Three kinds of classes, each with its equity spread its own way.
+void fake_histogram(std::uint64_t index, span<float> bins) {
+    switch (index % 3) {
+    case 0:  bins[0] = 1; break;
+    case 1:  bins[3] = 1; break;
+    default: bins[1] = 1; bins[2] = 1; break;
+    }
+    // A little noise.
+    bins[index % 4] += 0.01f * static_cast<float>(index % 7);
+}
+
+} // namespace
+
+TEST_CASE("Card abstraction") {
+    auto options = abstraction_options{};
+    options.num_buckets = 3;
+    options.num_bins = 4;
+    options.num_threads = 2;
+    constexpr auto num_classes = std::uint64_t{20000};
+    const auto abstraction = card_abstraction::build(num_classes, fake_histogram, options);
+    REQUIRE(abstraction.has_value());
+    REQUIRE_EQ(abstraction->num_buckets(), 3);
+    REQUIRE_EQ(abstraction->size(), num_classes);
+
+    SUBCASE("classes are bucketed by their histograms") {
+        for (auto i = std::uint64_t{3}; i < num_classes; ++i) {
+            REQUIRE_EQ(abstraction->bucket(i), abstraction->bucket(i % 3));
+        }
+        REQUIRE_NE(abstraction->bucket(0), abstraction->bucket(1));
+        REQUIRE_NE(abstraction->bucket(0), abstraction->bucket(2));
+        REQUIRE_NE(abstraction->bucket(1), abstraction->bucket(2));
+    }
+    SUBCASE("the buckets do not depend on the number of threads") {
+        options.num_threads = 1;
+        const auto other = card_abstraction::build(num_classes, fake_histogram, options);
+        for (auto i = std::uint64_t{0}; i < num_classes; ++i) REQUIRE_EQ(other->bucket(i), abstraction->bucket(i));
+    }
+    SUBCASE("a build that is cut short picks up where it left off") {
+        const auto path = "card_abstraction.test.checkpoint";
+        options.checkpoint_path = path;
+        options.num_threads = 1;
+        auto num_calls = std::uint64_t{0};
+        REQUIRE_THROWS(card_abstraction::build(num_classes, [&] (std::uint64_t index, span<float> bins) {
+            if (++num_calls == num_classes / 2) throw std::runtime_error{"cut short"};
+            fake_histogram(index, bins);
+        }, options));
+        num_calls = 0;
+        const auto resumed = card_abstraction::build(num_classes, [&] (std::uint64_t index, span<float> bins) {
+            ++num_calls;
+            fake_histogram(index, bins);
+        }, options);
+        REQUIRE(resumed.has_value());
+        REQUIRE_LT(num_calls, num_classes);
+        for (auto i = std::uint64_t{0}; i < num_classes; ++i) REQUIRE_EQ(resumed->bucket(i), abstraction->bucket(i));
+        std::remove(path);
+    }
+    SUBCASE("it survives a round trip through a file") {
+        const auto path = "card_abstraction.test.bin";
+        REQUIRE(abstraction->save(path));
+        const auto loaded = card_abstraction::load(path);
+        REQUIRE(loaded.has_value());
+        REQUIRE_EQ(loaded->size(), num_classes);
+        for (auto i = std::uint64_t{0}; i < num_classes; ++i) REQUIRE_EQ(loaded->bucket(i), abstraction->bucket(i));
+        std::remove(path);
+    }
+    SUBCASE("anything else is rejected") {
+        const auto path = "card_abstraction.test.bin";
+        {
+            auto out = std::ofstream{path, std::ios::binary};
+            out << "not a card abstraction";
+        }
+        REQUIRE_FALSE(card_abstraction::load(path).has_value());
+        std::remove(path);
+    }
+}
+
+TEST_CASE("Equity histograms") {
+    const auto hole_of = [] (const char* cards) {
+        auto result = card_set{};
+        for (auto c : debug::make_cards<2>(cards)) result.insert(c);
+        return result;
+    };
+    const auto board_of = [] (const auto& cards) {
+        auto result = card_set{};
+        for (auto c : cards) result.insert(c);
+        return result;
+    };
+    auto bins = std::array<float, 10>{};
+
+    SUBCASE("the nuts on the river are all in the top bin") {
+        detail::add_equity_histogram(hole_of("Jh Th"), board_of(debug::make_cards<5>("Ah Kh Qh 2c 3d")), bins);
+        REQUIRE_EQ(bins[9], 1);
+        REQUIRE_EQ(std::accumulate(bins.begin(), bins.end(), 0.0f), 1);
+    }
+    SUBCASE("every river is counted once on the turn") {
+        const auto hc = debug::make_cards<2>("Ad Qc");
+        const auto hole = hole_of("Ad Qc");
+        const auto turn = debug::make_cards<4>("3h 4c Jh 8h");
+        detail::add_equity_histogram(hole, board_of(turn), bins);
+        auto expected = std::array<float, 10>{};
+        for (auto c : ~(hole | board_of(turn))) {
+            const card board[] = {turn[0], turn[1], turn[2], turn[3], c};
+            const auto strength = hand_strength(hole_cards{hc[0], hc[1]}, board);
+            ++expected[std::min(static_cast<int>(strength * 10), 9)];
+        }
+        REQUIRE(bins == expected);
+    }
+}
@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <poker/card_set.hpp>
+#include <poker/community_cards.hpp>
+#include <poker/deck.hpp>
+#include <poker/hand.hpp>
+#include <poker/hole_cards.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+TEST_CASE("Hot structures fit in a cache line") {
+    REQUIRE_EQ(sizeof(card_index), 1);
+    REQUIRE_EQ(sizeof(card), 2);
+    REQUIRE_EQ(sizeof(card_set), 8);
+    REQUIRE_LE(sizeof(deck), 64);
+    REQUIRE_LE(sizeof(hole_cards), 64);
+    REQUIRE_LE(sizeof(community_cards), 64);
+    REQUIRE_LE(sizeof(hand), 64);
+}
+
+TEST_CASE("Card indices round-trip and keep the card order") {
+    auto previous = card{};
+    for (auto i = 0; i < 52; ++i) {
+        const auto c = to_card(static_cast<card_index>(i));
+        REQUIRE_EQ(static_cast<int>(to_card_index(c)), i);
+        if (i != 0) REQUIRE_LT(previous, c);
+        previous = c;
+    }
+}
+
+TEST_CASE("card_set") {
+    const auto cards = debug::make_cards<5>("Ac Kd 2c 7h As");
+    auto set = card_set{cards};
+
+    REQUIRE_EQ(set.size(), 5);
+    REQUIRE(set.contains(debug::make_card("Kd")));
+    REQUIRE_FALSE(set.contains(debug::make_card("Kc")));
+    REQUIRE_EQ(set.suit_mask(card_suit::clubs), (1u << 12 | 1u << 0));
+    REQUIRE_EQ(set.rank_mask(), (1u << 12 | 1u << 11 | 1u << 5 | 1u << 0));
+
+    SUBCASE("iterates in ascending card order") {
+        auto iterated = std::vector<card>(set.begin(), set.end());
+        auto sorted = std::vector<card>(cards.begin(), cards.end());
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(iterated == sorted);
+    }
+
+    SUBCASE("set algebra") {
+        const auto other = card_set{debug::make_cards<2>("Ac Qs")};
+        REQUIRE_EQ((set | other).size(), 6);
+        REQUIRE_EQ((set & other).size(), 1);
+        REQUIRE_EQ((set - other).size(), 4);
+        REQUIRE_EQ((set ^ other).size(), 5);
+        REQUIRE_EQ((~set).size(), 47);
+        REQUIRE_EQ(card_set::full().size(), 52);
+        set.erase(debug::make_card("Ac"));
+        REQUIRE_EQ(set, card_set{debug::make_cards<4>("Kd 2c 7h As")});
+        set.insert(to_card_index(debug::make_card("Ac")));
+        REQUIRE_EQ(set, card_set{cards});
+    }
+}
+
+TEST_CASE("A deck deals every card exactly once") {
+    auto d = deck{std::mt19937{}};
+    auto dealt = card_set{};
+    while (d.size() != 0) {
+        const auto c = d.draw();
+        REQUIRE_FALSE(dealt.contains(c));
+        dealt.insert(c);
+    }
+    REQUIRE_EQ(dealt, card_set::full());
+}
@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include <poker/combinations.hpp>
+#include <poker/community_cards.hpp>
+#include <poker/deck.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+TEST_CASE("Card combinations") {
+    SUBCASE("every subset comes once, numbered in order") {
+        const auto cards = card_set{debug::make_cards<9>("2c 5c Td Ad 3h 9h Kh 4s Qs")};
+        for (auto k = 0; k <= 9; ++k) {
+            const auto combinations = card_combinations{cards, k};
+            auto seen = std::set<std::uint64_t>{};
+            auto index = std::uint64_t{0};
+            combinations.for_each([&] (card_set subset) {
+                REQUIRE_EQ(subset.size(), k);
+                REQUIRE((subset - cards).empty());
+                REQUIRE(seen.insert(subset.bits()).second);
+                REQUIRE_EQ(combinations.rank(subset), index);
+                REQUIRE_EQ(combinations.unrank(index), subset);
+                if (index + 1 < combinations.size()) REQUIRE_EQ(combinations.next(subset), combinations.unrank(index + 1));
+                ++index;
+            });
+            REQUIRE_EQ(index, combinations.size());
+        }
+        REQUIRE_EQ(card_combinations(cards, 4).size(), 126);
+        REQUIRE_EQ(card_combinations(card_set::full(), 7).size(), 133784560);
+    }
+    SUBCASE("ranges cut the subsets evenly and can be walked on their own") {
+        const auto combinations = card_combinations{card_set::full(), 3};
+        for (auto num_ranges : {1, 7, 64, 22100, 30000}) {
+            auto expected = std::uint64_t{0};
+            auto walked = std::vector<card_set>{};
+            for (auto r = 0; r < num_ranges; ++r) {
+                const auto [first, last] = combinations.range(r, num_ranges);
+                REQUIRE_EQ(first, expected);
+                REQUIRE_LE(last - first, combinations.size() / num_ranges + 1);
+                REQUIRE_GE(last - first, combinations.size() / num_ranges);
+                combinations.for_each(first, last, [&] (card_set subset) { walked.push_back(subset); });
+                expected = last;
+            }
+            REQUIRE_EQ(expected, combinations.size());
+            for (auto i = std::size_t{0}; i < walked.size(); i += 97) REQUIRE_EQ(combinations.unrank(i), walked[i]);
+        }
+    }
+    SUBCASE("a walk picks up from any number") {
+        const auto combinations = card_combinations{card_set::full(), 5};
+        auto g = std::mt19937_64{7};
+        for (auto i = 0; i < 1000; ++i) {
+            const auto first = g() % combinations.size();
+            auto expected = combinations.unrank(first);
+            combinations.for_each(first, std::min(first + 10, combinations.size()), [&] (card_set subset) {
+                REQUIRE_EQ(subset, expected);
+                if (combinations.rank(subset) + 1 < combinations.size()) expected = combinations.next(subset);
+            });
+        }
+    }
+    SUBCASE("boards from what is left of the deck") {
+        auto d = deck{std::mt19937{1}};
+        auto cc = community_cards{};
+        const card flop[] = {d.draw(), d.draw(), d.draw()};
+        cc.deal(flop);
+        auto hole = card_set{};
+        hole.insert(d.draw());
+        hole.insert(d.draw());
+        REQUIRE_EQ(d.cards().size(), 47);
+        REQUIRE((d.cards() & (hole | card_set{cc.cards()})).empty());
+        const auto runouts = card_combinations{d.cards(), 5 - static_cast<int>(cc.cards().size())};
+        REQUIRE_EQ(runouts.size(), 1081);
+        runouts.for_each([&] (card_set cards) { REQUIRE((cards & (hole | card_set{cc.cards()})).empty()); });
+    }
+}
@@ -0,0 +1,84 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <random>
+#include <utility>
+
+#include <poker/card_set.hpp>
+#include <poker/deck.hpp>
+
+using namespace poker;
+
+TEST_CASE("Deck") {
+    auto g = std::mt19937{24};
+    auto d = deck{g};
+
+    SUBCASE("every card is drawn once, however often the deck is refilled") {
+        for (auto i = 0; i < 3; ++i) {
+            REQUIRE_EQ(d.size(), 52);
+            auto drawn = card_set{};
+            while (d.size() != 0) {
+                const auto c = d.draw();
+                REQUIRE_FALSE(drawn.contains(c));
+                drawn.insert(c);
+            }
+            REQUIRE_EQ(drawn, card_set::full());
+            d.fill_and_shuffle(g);
+        }
+    }
+    SUBCASE("a refill takes back the cards of a hand cut short") {
+        for (auto i = 0; i < 12; ++i) static_cast<void>(d.draw());
+        d.fill_and_shuffle(g);
+        REQUIRE_EQ(d.size(), 52);
+        auto drawn = card_set{};
+        while (d.size() != 0) drawn.insert(d.draw());
+        REQUIRE_EQ(drawn, card_set::full());
+    }
+    SUBCASE("a hand can shuffle only the cards it deals") {
+        for (auto i = 0; i < 3; ++i) {
+            d.fill_and_shuffle_first(g, 23);
+            REQUIRE_EQ(d.size(), 52);
+            auto drawn = card_set{};
+            for (auto j = 0; j < 23; ++j) drawn.insert(d.draw());
+            REQUIRE_EQ(drawn.size(), 23);
+            REQUIRE_EQ(drawn | d.cards(), card_set::full());
+        }
+    }
+    SUBCASE("drawing with the caller's generator") {
+        auto drawn = card_set{};
+        while (d.size() != 0) {
+            const auto c = d.draw(g);
+            REQUIRE_FALSE(drawn.contains(c));
+            drawn.insert(c);
+        }
+        REQUIRE_EQ(drawn, card_set::full());
+    }
+    SUBCASE("every card is as likely to come at any point") {
+        // How often each card comes third, over as many deals as it takes
+        // for each to come 1000 times on average.
+        auto counts = std::array<int, 52>{};
+        for (auto i = 0; i < 52000; ++i) {
+            d.fill_and_shuffle_first(g, 3);
+            static_cast<void>(d.draw());
+            static_cast<void>(d.draw());
+            ++counts[static_cast<int>(to_card_index(d.draw()))];
+        }
+        auto chi_square = 0.0;
+        for (auto n : counts) chi_square += (n - 1000.0) * (n - 1000.0) / 1000.0;
+        // The 99.9th percentile with 51 degrees of freedom.
+        REQUIRE_LT(chi_square, 93.2);
+    }
+    SUBCASE("a hand is dealt again from its seed and number alone") {
+        const auto deal = [] (deck&& d) {
+            auto cards = std::array<card, 9>{};
+            for (auto& c : cards) c = d.draw();
+            return cards;
+        };
+        const auto hand = deal(deck{42, 1000});
+        REQUIRE_EQ(deal(deck{42, 1000}), hand);
+        d.fill_and_shuffle(42, 1000);
+        REQUIRE_EQ(deal(std::move(d)), hand);
+        REQUIRE_NE(deal(deck{42, 1001}), hand);
+        REQUIRE_NE(deal(deck{43, 1000}), hand);
+    }
+}
@@ -20,3 +20,71 @@ TEST_CASE("whatever") {
     REQUIRE_EQ(pm.pots()[1].size(), 40);
     REQUIRE_EQ(pm.pots()[2].size(), 20);
 }
+
+TEST_CASE("pots are split between the best eligible hands") {
+    auto players = seat_array{};
+    players.add_player(0, player{100});
+    players.add_player(1, player{100});
+    players.add_player(2, player{100});
+    players[0].bet(20);
+    players[1].bet(40);
+    players[2].bet(40);
+    auto pm = pot_manager{};
+    pm.collect_bets_from(players);
+    const int ranks[] = {3, 2, 2};
+    pm.award(players, [&] (seat_index i) { return ranks[i]; });
+    REQUIRE_EQ(players[0].stack(), 80 + 60);
+    REQUIRE_EQ(players[1].stack(), 60 + 20);
+    REQUIRE_EQ(players[2].stack(), 60 + 20);
+}
+
+TEST_CASE("every hand is evaluated once however many pots it is in") {
+    auto players = seat_array{};
+    for (auto i = 0; i < 4; ++i) players.add_player(i, player{100});
+    players[0].bet(10);
+    players[1].bet(20);
+    players[2].bet(30);
+    players[3].bet(30);
+    auto pm = pot_manager{};
+    pm.collect_bets_from(players);
+    REQUIRE_EQ(pm.pots().size(), 3);
+    const int ranks[] = {1, 4, 2, 2};
+    int num_calls[4] = {};
+    pm.award(players, [&] (seat_index i) {
+        ++num_calls[i];
+        return ranks[i];
+    });
+    for (auto n : num_calls) REQUIRE_EQ(n, 1);
+    REQUIRE_EQ(players[0].stack(), 90);
+    REQUIRE_EQ(players[1].stack(), 80 + 40 + 30);
+    REQUIRE_EQ(players[2].stack(), 70 + 10);
+    REQUIRE_EQ(players[3].stack(), 70 + 10);
+}
+
+TEST_CASE("pots are split between the best high and low hands") {
+    auto players = seat_array{};
+    players.add_player(0, player{100});
+    players.add_player(1, player{100});
+    players.add_player(2, player{100});
+    players[0].bet(21);
+    players[1].bet(21);
+    players[2].bet(21);
+    auto pm = pot_manager{};
+    pm.collect_bets_from(players);
+    const int highs[] = {3, 2, 1};
+
+    SUBCASE("the high half gets the odd chip") {
+        const int lows[] = {0, 1, 2};
+        pm.award(players, [&] (seat_index i) { return highs[i]; }, [&] (seat_index i) { return lows[i]; });
+        REQUIRE_EQ(players[0].stack(), 79 + 32);
+        REQUIRE_EQ(players[1].stack(), 79);
+        REQUIRE_EQ(players[2].stack(), 79 + 31);
+    }
+    SUBCASE("without a low the high hand scoops") {
+        const int lows[] = {0, 0, 0};
+        pm.award(players, [&] (seat_index i) { return highs[i]; }, [&] (seat_index i) { return lows[i]; });
+        REQUIRE_EQ(players[0].stack(), 79 + 63);
+        REQUIRE_EQ(players[1].stack(), 79);
+        REQUIRE_EQ(players[2].stack(), 79);
+    }
+}
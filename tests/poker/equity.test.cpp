@@ -0,0 +1,178 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#include <poker/equity.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+TEST_CASE("Exhaustive equity") {
+    SUBCASE("aces against kings before the flop") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah As"), debug::make_hole_cards("Kh Ks")};
+        const auto result = exhaustive_equity(players, {});
+        REQUIRE_EQ(result.size(), 2);
+        REQUIRE(result[0].equity == doctest::Approx(0.8264).epsilon(0.001));
+        REQUIRE(result[0].equity + result[1].equity == doctest::Approx(1));
+        REQUIRE(result[0].win + result[1].win + result[0].tie == doctest::Approx(1));
+    }
+    SUBCASE("on the flop it matches playing out every turn and river") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah Kh"), debug::make_hole_cards("Qs Qd"), debug::make_hole_cards("7c 6c")};
+        const auto flop = debug::make_cards<3>("Qh 8c 2h");
+        auto expected = std::vector<double>(3);
+        auto num_boards = 0;
+        auto dead = card_set{flop};
+        for (const auto& p : players) {
+            dead.insert(p.first);
+            dead.insert(p.second);
+        }
+        for (auto turn : ~dead) {
+            for (auto river : ~dead) {
+                if (!(to_card_index(turn) < to_card_index(river))) continue;
+                auto board = card_set{flop};
+                board.insert(turn);
+                board.insert(river);
+                hand_rank ranks[3];
+                auto best = hand_rank{};
+                for (auto i = 0; i < 3; ++i) {
+                    auto cards = board;
+                    cards.insert(players[i].first);
+                    cards.insert(players[i].second);
+                    ranks[i] = evaluate_rank(cards);
+                    best = std::max(best, ranks[i]);
+                }
+                const auto num_winners = std::count(std::begin(ranks), std::end(ranks), best);
+                for (auto i = 0; i < 3; ++i) {
+                    if (ranks[i] == best) expected[i] += 1.0 / static_cast<double>(num_winners);
+                }
+                ++num_boards;
+            }
+        }
+        const auto result = exhaustive_equity(players, flop, 3);
+        for (auto i = 0; i < 3; ++i) {
+            REQUIRE(result[i].equity == doctest::Approx(expected[i] / num_boards));
+        }
+    }
+    SUBCASE("the number of threads does not change the result") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah Kd"), debug::make_hole_cards("Jc Ts"), debug::make_hole_cards("5h 5s")};
+        const auto board = debug::make_cards<4>("Kc 9h 5d 2c");
+        const auto one = exhaustive_equity(players, board, 1);
+        const auto four = exhaustive_equity(players, board, 4);
+        for (auto i = 0; i < 3; ++i) {
+            REQUIRE_EQ(one[i].equity, four[i].equity);
+            REQUIRE_EQ(one[i].win, four[i].win);
+        }
+    }
+}
+
+TEST_CASE("Monte Carlo equity") {
+    SUBCASE("it converges to the exact equity") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah As"), debug::make_hole_cards("Kh Ks")};
+        auto options = monte_carlo_options{};
+        options.max_standard_error = 0;
+        options.time_budget = std::chrono::hours{1};
+        options.max_samples = 100000;
+        options.num_threads = 1;
+        const auto result = monte_carlo_equity(players, {}, options);
+        REQUIRE_EQ(result.num_samples, 100000);
+        REQUIRE_EQ(result.standard_errors.size(), 2);
+        REQUIRE(std::abs(result.players[0].equity - 0.8264) < 4 * result.standard_errors[0]);
+        REQUIRE(result.players[0].equity + result.players[1].equity == doctest::Approx(1));
+    }
+    SUBCASE("it stops once the standard error is small enough") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah Kd"), debug::make_hole_cards("Jc Ts"), debug::make_hole_cards("5h 5s")};
+        const auto flop = debug::make_cards<3>("Kc 9h 5d");
+        auto options = monte_carlo_options{};
+        options.max_standard_error = 0.005;
+        options.time_budget = std::chrono::hours{1};
+        options.num_threads = 2;
+        const auto result = monte_carlo_equity(players, flop, options);
+        const auto exact = exhaustive_equity(players, flop);
+        for (auto i = 0; i < 3; ++i) {
+            REQUIRE_LE(result.standard_errors[i], 0.005);
+            REQUIRE(std::abs(result.players[i].equity - exact[i].equity) < 5 * 0.005);
+        }
+    }
+    SUBCASE("results do not depend on the number of threads") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah Kd"), debug::make_hole_cards("Jc Ts")};
+        auto options = monte_carlo_options{};
+        options.max_standard_error = 0;
+        options.time_budget = std::chrono::hours{1};
+        options.max_samples = 10000;
+        options.num_unknown_players = 1;
+        options.seed = 3;
+        options.num_threads = 1;
+        const auto one = monte_carlo_equity(players, {}, options);
+        options.num_threads = 3;
+        const auto three = monte_carlo_equity(players, {}, options);
+        for (auto i = 0; i < 2; ++i) {
+            REQUIRE_EQ(one.players[i].equity, three.players[i].equity);
+            REQUIRE_EQ(one.players[i].win, three.players[i].win);
+        }
+    }
+    SUBCASE("unknown players are dealt random hands") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah As")};
+        auto options = monte_carlo_options{};
+        options.max_standard_error = 0.002;
+        options.time_budget = std::chrono::hours{1};
+        options.num_unknown_players = 1;
+        options.seed = 7;
+        const auto result = monte_carlo_equity(players, {}, options);
+        REQUIRE_EQ(result.players.size(), 1);
+        REQUIRE(std::abs(result.players[0].equity - 0.852) < 4 * result.standard_errors[0]);
+    }
+}
+
+TEST_CASE("Range equity") {
+    SUBCASE("single combos match the exhaustive equity") {
+        const hole_cards players[] = {debug::make_hole_cards("Ah Kh"), debug::make_hole_cards("7s 7c")};
+        const auto flop = debug::make_cards<3>("Kc 7h 2h");
+        auto first = hand_range{};
+        auto second = hand_range{};
+        first.set_weight(players[0], 1);
+        second.set_weight(players[1], 1);
+        const auto expected = exhaustive_equity(players, flop);
+        const auto result = range_equity(first, second, flop);
+        for (auto i = 0; i < 2; ++i) {
+            REQUIRE(result[i].equity == doctest::Approx(expected[i].equity));
+            REQUIRE(result[i].win == doctest::Approx(expected[i].win));
+            REQUIRE(result[i].tie == doctest::Approx(expected[i].tie));
+        }
+    }
+    SUBCASE("blocked combos are left out and the others weighted") {
+        const char* first_combos[] = {"Ah As", "Ad Ac", "Qh Qs", "9d 8d"};
+        const double first_weights[] = {1, 0.5, 1, 0.25};
+        const char* second_combos[] = {"Ah Kh", "Ks Kd", "Qd Jd"};
+        const double second_weights[] = {1, 1, 0.75};
+        const auto turn = debug::make_cards<4>("Kc Qc 4d 2s");
+        auto first = hand_range{};
+        auto second = hand_range{};
+        for (auto i = 0; i < 4; ++i) first.set_weight(debug::make_hole_cards(first_combos[i]), first_weights[i]);
+        for (auto i = 0; i < 3; ++i) second.set_weight(debug::make_hole_cards(second_combos[i]), second_weights[i]);
+        auto expected = 0.0;
+        auto total = 0.0;
+        for (auto i = 0; i < 4; ++i) {
+            for (auto j = 0; j < 3; ++j) {
+                const hole_cards players[] = {debug::make_hole_cards(first_combos[i]), debug::make_hole_cards(second_combos[j])};
+                auto cards = card_set{turn};
+                const auto count = cards.size() + 4;
+                cards.insert(players[0].first);
+                cards.insert(players[0].second);
+                cards.insert(players[1].first);
+                cards.insert(players[1].second);
+                if (cards.size() != count) continue;
+                const auto weight = first_weights[i] * second_weights[j];
+                expected += weight * exhaustive_equity(players, turn)[0].equity;
+                total += weight;
+            }
+        }
+        const auto result = range_equity(first, second, turn, 2);
+        REQUIRE(result[0].equity == doctest::Approx(expected / total));
+        REQUIRE(result[0].equity + result[1].equity == doctest::Approx(1));
+    }
+}
@@ -1,6 +1,10 @@
 #include <doctest/doctest.h>
 
+#include <algorithm>
 #include <iostream>
+#include <random>
+
+#include <poker/deck.hpp>
 #include <poker/hand.hpp>
 #include <poker/debug/card.hpp>
 #include <poker/debug/hand.hpp>
@@ -26,7 +30,7 @@ TEST_CASE("high/low hand evaluation") {
     constexpr poker::hand_ranking hand_rankings[] = {
         poker::hand_ranking::four_of_a_kind,
         poker::hand_ranking::full_house,
-        poker::hand_ranking::three_of_a_kind,
+        poker::hand_ranking::full_house,
         poker::hand_ranking::two_pair,
         poker::hand_ranking::pair,
         poker::hand_ranking::high_card,
@@ -62,3 +66,88 @@ TEST_CASE("straight/flush hand evaluation") {
         REQUIRE_EQ(hands[i].ranking(), hand_rankings[i]);
     }
 }
+
+TEST_CASE("three pairs use the best remaining kicker") {
+    auto cards = poker::debug::make_cards<7>("Ac Ad Kc Kd Qs 2c 2d");
+    const auto h = poker::hand::_high_low_hand_eval(cards);
+    REQUIRE_EQ(h.ranking(), poker::hand_ranking::two_pair);
+    REQUIRE_EQ(h.cards()[4].rank, poker::card_rank::Q);
+}
+
+TEST_CASE("table-driven evaluation agrees with the reference evaluation") {
+    auto g = std::mt19937{20181111};
+    for (auto i = 0; i < 20000; ++i) {
+        auto d = poker::deck{g};
+        std::array<poker::card, 7> cards;
+        std::generate(cards.begin(), cards.end(), [&] { return d.draw(); });
+        auto reference_cards = cards;
+        auto reference = poker::hand::_high_low_hand_eval(reference_cards);
+        if (auto h = poker::hand::_straight_flush_eval(reference_cards)) {
+            reference = std::max(reference, *h);
+        }
+        const auto h = poker::hand{cards};
+        REQUIRE_EQ(h.ranking(), reference.ranking());
+        REQUIRE_EQ(h.strength(), reference.strength());
+        for (auto c : h.cards()) {
+            REQUIRE(std::find(cards.begin(), cards.end(), c) != cards.end());
+        }
+    }
+}
+
+TEST_CASE("evaluate_rank orders hands the way hand does") {
+    auto g = std::mt19937{42};
+    auto previous = poker::hand{};
+    auto previous_rank = poker::hand_rank{};
+    for (auto i = 0; i < 2000; ++i) {
+        auto d = poker::deck{g};
+        const auto hc = poker::hole_cards{d.draw(), d.draw()};
+        auto cc = poker::community_cards{};
+        const auto board = std::array<poker::card, 5>{d.draw(), d.draw(), d.draw(), d.draw(), d.draw()};
+        cc.deal(board);
+        const auto h = poker::hand{hc, cc};
+        const auto rank = poker::evaluate_rank(hc, cc);
+        REQUIRE_EQ(rank, h.rank());
+        REQUIRE_EQ(rank.ranking(), h.ranking());
+        REQUIRE_EQ(rank < previous_rank, h < previous);
+        REQUIRE_EQ(rank == previous_rank, h == previous);
+        previous = h;
+        previous_rank = rank;
+    }
+}
+
+TEST_CASE("five and six cards rank as the best five cards out of them") {
+    auto g = std::mt19937{31337};
+    const auto best_without_one = [] (poker::card_set cards) {
+        auto best = poker::hand_rank{};
+        for (auto c : cards) best = std::max(best, poker::evaluate_rank(cards - poker::card_set{{&c, 1}}));
+        return best;
+    };
+    for (auto i = 0; i < 5000; ++i) {
+        auto d = poker::deck{g};
+        auto cards = poker::card_set{};
+        for (auto j = 0; j < 5; ++j) cards.insert(d.draw());
+        auto five = std::array<poker::card, 5>{};
+        std::copy(cards.begin(), cards.end(), five.begin());
+        REQUIRE_EQ(poker::evaluate_rank(five), poker::evaluate_rank(cards));
+        cards.insert(d.draw());
+        REQUIRE_EQ(poker::evaluate_rank(cards), best_without_one(cards));
+        cards.insert(d.draw());
+        REQUIRE_EQ(poker::evaluate_rank(cards), best_without_one(cards));
+    }
+
+    SUBCASE("on the flop and the turn") {
+        auto d = poker::deck{g};
+        const auto hc = poker::hole_cards{d.draw(), d.draw()};
+        auto cc = poker::community_cards{};
+        const auto flop = std::array<poker::card, 3>{d.draw(), d.draw(), d.draw()};
+        cc.deal(flop);
+        auto cards = poker::card_set{cc.cards()};
+        cards.insert(hc.first);
+        cards.insert(hc.second);
+        REQUIRE_EQ(poker::evaluate_rank(hc, cc), poker::evaluate_rank(cards));
+        const auto turn = std::array<poker::card, 1>{d.draw()};
+        cc.deal(turn);
+        cards.insert(turn[0]);
+        REQUIRE_EQ(poker::evaluate_rank(hc, cc), poker::evaluate_rank(cards));
+    }
+}
@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <poker/deck.hpp>
+#include <poker/hand_indexer.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+TEST_CASE("Hand indexer") {
+    const auto indexer = hand_indexer::holdem();
+
+    SUBCASE("numbers the classes of hold'em deals") {
+        REQUIRE_EQ(indexer.num_rounds(), 4);
+        REQUIRE_EQ(indexer.size(0), 169);
+        REQUIRE_EQ(indexer.size(1), 1286792);
+        REQUIRE_EQ(indexer.size(2), 55190538);
+        REQUIRE_EQ(indexer.size(3), 2428287420);
+    }
+    SUBCASE("numbers the classes of whole boards") {
+        const int turn[] = {2, 4};
+        const int river[] = {2, 5};
+        REQUIRE_EQ(hand_indexer{turn}.size(1), 13960050);
+        REQUIRE_EQ(hand_indexer{river}.size(1), 123156254);
+    }
+    SUBCASE("every starting hand has an index") {
+        auto seen = std::vector<int>(indexer.size(0));
+        for (auto i = 0; i < 52; ++i) {
+            for (auto j = 0; j < 52; ++j) {
+                if (i == j) continue;
+                const auto hc = hole_cards{to_card(static_cast<card_index>(i)), to_card(static_cast<card_index>(j))};
+                const auto index = indexer.index(hc, {});
+                REQUIRE_LT(index, indexer.size(0));
+                ++seen[index];
+            }
+        }
+        // Pairs come in 6 combos, suited hands in 4 and offsuit ones in 12,
+        // each dealt in either order.
+        for (auto n : seen) REQUIRE((n == 12 || n == 8 || n == 24));
+    }
+    SUBCASE("indexing the representative of a flop class gives its index") {
+        auto cards = std::array<card, 5>{};
+        for (auto i = std::uint64_t{0}; i < indexer.size(1); ++i) {
+            indexer.unindex(1, i, cards);
+            REQUIRE_EQ(indexer.index(cards), i);
+        }
+    }
+    SUBCASE("deals that only differ in their suits share an index") {
+        const auto deal = debug::make_cards<7>("Ah Kh Qh Jd 2h 2c 7s");
+        const auto other = debug::make_cards<7>("As Ks Qs Jc 2s 2d 7h");
+        REQUIRE_EQ(indexer.index(deal), indexer.index(other));
+        REQUIRE_EQ(indexer.index(span<const card>(deal).first(5)), indexer.index(span<const card>(other).first(5)));
+        // Swapping the turn and the river makes another deal.
+        const auto swapped = debug::make_cards<7>("Ah Kh Qh Jd 2h 7s 2c");
+        REQUIRE_NE(indexer.index(deal), indexer.index(swapped));
+    }
+    SUBCASE("random deals survive the round trip") {
+        auto g = std::mt19937{1755};
+        auto suits = std::array<int, 4>{0, 1, 2, 3};
+        for (auto i = 0; i < 20000; ++i) {
+            auto d = deck{g};
+            auto cards = std::array<card, 7>{};
+            std::generate(cards.begin(), cards.end(), [&] { return d.draw(); });
+            std::shuffle(suits.begin(), suits.end(), g);
+            auto relabelled = cards;
+            for (auto& c : relabelled) c.suit = static_cast<card_suit>(suits[static_cast<int>(c.suit)]);
+            for (auto round = 0; round < 4; ++round) {
+                const auto n = static_cast<std::size_t>(indexer.num_cards(round));
+                const auto index = indexer.index(span<const card>(cards).first(n));
+                REQUIRE_LT(index, indexer.size(round));
+                REQUIRE_EQ(indexer.index(span<const card>(relabelled).first(n)), index);
+                auto representative = std::array<card, 7>{};
+                indexer.unindex(round, index, span<card>(representative).first(n));
+                REQUIRE_EQ(indexer.index(span<const card>(representative).first(n)), index);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#include <doctest/doctest.h>
+
+#include <poker/hand_strength.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+// Plays every opponent hand out on every board to come one at a time.
+auto reference_metrics(const hole_cards& hc, span<const card> board) -> hand_strength_metrics {
+    auto hole = card_set{};
+    hole.insert(hc.first);
+    hole.insert(hc.second);
+    const auto known = card_set{board};
+    const auto live = ~(hole | known);
+    const auto outcome = [] (hand_rank x, hand_rank y) { return x > y ? 0 : x == y ? 1 : 2; };
+    double hp[3][3] = {}, totals[3] = {};
+    for (auto o1 : live) {
+        for (auto o2 : live) {
+            if (to_card_index(o2) <= to_card_index(o1)) continue;
+            auto opponent = card_set{};
+            opponent.insert(o1);
+            opponent.insert(o2);
+            const auto now = outcome(evaluate_rank(hole | known), evaluate_rank(opponent | known));
+            ++totals[now];
+            const auto rest = live - opponent;
+            for (auto x : rest) {
+                for (auto y : rest) {
+                    if (known.size() == 5 || (known.size() == 3 && to_card_index(y) <= to_card_index(x))) continue;
+                    auto river = known;
+                    river.insert(x);
+                    if (known.size() == 3) river.insert(y);
+                    ++hp[now][outcome(evaluate_rank(hole | river), evaluate_rank(opponent | river))];
+                    if (known.size() == 4) break;
+                }
+            }
+        }
+    }
+    auto result = hand_strength_metrics{};
+    result.strength = (totals[0] + totals[1] / 2) / (totals[0] + totals[1] + totals[2]);
+    const auto sum = [&] (int now) { return hp[now][0] + hp[now][1] + hp[now][2]; };
+    if (sum(2) + sum(1) > 0) result.positive_potential = (hp[2][0] + hp[2][1] / 2 + hp[1][0] / 2) / (sum(2) + sum(1) / 2);
+    if (sum(0) + sum(1) > 0) result.negative_potential = (hp[0][2] + hp[0][1] / 2 + hp[1][2] / 2) / (sum(0) + sum(1) / 2);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Hand strength") {
+    SUBCASE("the nuts win against every hand on the river") {
+        const auto board = debug::make_cards<5>("Ah Kh Qh 2c 3d");
+        REQUIRE_EQ(hand_strength(debug::make_hole_cards("Jh Th"), board), 1);
+        REQUIRE_EQ(effective_hand_strength(debug::make_hole_cards("Jh Th"), board).effective_strength, 1);
+    }
+    SUBCASE("more opponents make a hand weaker") {
+        const auto board = debug::make_cards<3>("3h 4c Jh");
+        const auto hs = hand_strength(debug::make_hole_cards("Ad Qc"), board);
+        REQUIRE(hand_strength(debug::make_hole_cards("Ad Qc"), board, 3) == doctest::Approx(hs * hs * hs));
+    }
+    SUBCASE("metrics match playing out every hand one at a time") {
+        const auto check = [] (const hole_cards& hc, span<const card> board) {
+            const auto expected = reference_metrics(hc, board);
+            const auto metrics = effective_hand_strength(hc, board, 1, 2);
+            REQUIRE(metrics.strength == doctest::Approx(expected.strength));
+            REQUIRE(metrics.positive_potential == doctest::Approx(expected.positive_potential));
+            REQUIRE(metrics.negative_potential == doctest::Approx(expected.negative_potential));
+            REQUIRE(metrics.effective_strength == doctest::Approx(
+                expected.strength * (1 - expected.negative_potential) + (1 - expected.strength) * expected.positive_potential));
+        };
+        check(debug::make_hole_cards("Ad Qc"), debug::make_cards<4>("3h 4c Jh 8h"));
+        check(debug::make_hole_cards("Ah 2c"), debug::make_cards<3>("5h 9h Kh"));
+        check(debug::make_hole_cards("Ks Kc"), debug::make_cards<4>("Kh Kd 7h 2h"));
+        check(debug::make_hole_cards("Ad 2c"), debug::make_cards<5>("5h 9h Kh 7h 3h"));
+        check(debug::make_hole_cards("Qh 2c"), debug::make_cards<5>("5h 9h Kh 7s 3h"));
+    }
+    SUBCASE("potentials on the flop") {
+        // The example worked out by Billings et al. in "Opponent Modeling in
+        // Poker".
+        const auto metrics = effective_hand_strength(debug::make_hole_cards("Ad Qc"), debug::make_cards<3>("3h 4c Jh"));
+        REQUIRE(metrics.strength == doctest::Approx(0.585).epsilon(0.001));
+        REQUIRE(metrics.positive_potential == doctest::Approx(0.208).epsilon(0.001));
+        REQUIRE(metrics.negative_potential == doctest::Approx(0.274).epsilon(0.001));
+    }
+}
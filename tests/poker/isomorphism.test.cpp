@@ -0,0 +1,63 @@
+#include <doctest/doctest.h>
+
+#include <set>
+
+#include <poker/isomorphism.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+// Calls 'f' with every set of 'n' cards.
+template<class F>
+void for_each_subset(int n, F f, int start = 0, card_set cards = {}) {
+    if (n == 0) {
+        f(cards);
+        return;
+    }
+    for (auto i = start; i <= 52 - n; ++i) {
+        auto next = cards;
+        next.insert(static_cast<card_index>(i));
+        for_each_subset(n - 1, f, i + 1, next);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Canonical deals") {
+    SUBCASE("there are 169 starting hands") {
+        auto classes = std::set<std::uint64_t>{};
+        auto total = 0;
+        for_each_subset(2, [&] (card_set hole) {
+            const auto deal = canonicalize(hole, {});
+            if (classes.insert(deal.hole.bits()).second) total += deal.multiplicity;
+        });
+        REQUIRE_EQ(classes.size(), 169);
+        REQUIRE_EQ(total, 1326);
+    }
+    SUBCASE("there are 1755 flops") {
+        auto classes = std::set<std::uint64_t>{};
+        auto total = 0;
+        for_each_subset(3, [&] (card_set flop) {
+            const auto deal = canonicalize(flop);
+            REQUIRE_EQ(deal.board.size(), 3);
+            if (classes.insert(deal.board.bits()).second) total += deal.multiplicity;
+        });
+        REQUIRE_EQ(classes.size(), 1755);
+        REQUIRE_EQ(total, 22100);
+    }
+    SUBCASE("deals that differ in their suits only share a representative") {
+        const auto hole = debug::make_hole_cards("Ah Kh");
+        const auto other = debug::make_hole_cards("As Ks");
+        const auto board = debug::make_cards<4>("Qh Jd 2h 2c");
+        const auto other_board = debug::make_cards<4>("Qs Jc 2s 2d");
+        const auto deal = canonicalize(hole, board);
+        const auto other_deal = canonicalize(other, other_board);
+        REQUIRE_EQ(deal.hole, other_deal.hole);
+        REQUIRE_EQ(deal.board, other_deal.board);
+        REQUIRE_EQ(deal.multiplicity, 24);
+        REQUIRE_EQ(relabel(hole.first, deal), relabel(other.first, other_deal));
+        REQUIRE_NE(canonicalize(hole, debug::make_cards<4>("Qh Jd 2d 2c")).board, deal.board);
+    }
+}
@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <poker/deck.hpp>
+#include <poker/low_rank.hpp>
+#include <poker/omaha.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+auto low_of(const char* cards) -> low_rank {
+    const auto c = debug::make_cards<7>(cards);
+    return evaluate_low_rank(card_set{c});
+}
+
+} // namespace
+
+TEST_CASE("Eight-or-better lows") {
+    const auto wheel = low_of("Ac 2d 3h 4s 5c Kd Kh");
+    REQUIRE(wheel.qualifies());
+    REQUIRE_GT(wheel, low_of("Ac 2d 3h 4s 6c Kd Kh"));
+    REQUIRE_GT(low_of("Ac 2d 3h 4s 6c Kd Kh"), low_of("Ac 2d 3h 5s 6c Kd Kh"));
+    REQUIRE(low_of("8c 7d 6h 5s 4c Kd Kh").qualifies());
+    REQUIRE_LT(low_of("8c 7d 6h 5s 4c Kd Kh"), low_of("8c 7d 6h 5s 3c Kd Kh"));
+    REQUIRE_EQ(low_of("2c 2d 3h 3s 4c 5d 6h"), low_of("2c Td 3h Qs 4c 5d 6h"));
+    REQUIRE_FALSE(low_of("9c 7d 6h 5s 4c Kd Kh").qualifies());
+    REQUIRE_FALSE(low_of("Ac Ad 2h 2s 3c 3d 4h").qualifies());
+    // Straights and flushes do not spoil a low.
+    REQUIRE_EQ(low_of("Ac 2c 3c 4c 5c Kd Kh"), wheel);
+}
+
+TEST_CASE("Omaha lows use exactly two hole cards") {
+    const auto board = debug::make_cards<5>("2c 3d 4h Kc Qd");
+    REQUIRE_FALSE(evaluate_omaha_low_rank(debug::make_cards<4>("Ac Kd Qh Js"), board).qualifies());
+    REQUIRE_EQ(evaluate_omaha_low_rank(debug::make_cards<4>("Ac 5d Qh Js"), board), low_of("Ac 5d 2c 3d 4h Kc Kd"));
+    // A hole card pairing the board does not help.
+    REQUIRE_FALSE(evaluate_omaha_low_rank(debug::make_cards<4>("Ac 2d Qh Js"), board).qualifies());
+
+    auto g = std::mt19937{8};
+    for (auto i = 0; i < 5000; ++i) {
+        auto d = deck{g};
+        auto hole = std::array<card, 4>{};
+        auto board = std::array<card, 5>{};
+        for (auto& c : hole) c = d.draw();
+        for (auto& c : board) c = d.draw();
+        auto best = low_rank{};
+        for (auto a = 0; a < 4; ++a)
+        for (auto b = a + 1; b < 4; ++b)
+        for (auto x = 0; x < 5; ++x)
+        for (auto y = x + 1; y < 5; ++y)
+        for (auto z = y + 1; z < 5; ++z) {
+            const auto cards = std::array<card, 5>{hole[a], hole[b], board[x], board[y], board[z]};
+            best = std::max(best, evaluate_low_rank(card_set{cards}));
+        }
+        REQUIRE_EQ(evaluate_omaha_low_rank(hole, board), best);
+    }
+}
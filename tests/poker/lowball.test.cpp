@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <random>
+
+#include <poker/deck.hpp>
+#include <poker/lowball.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+template<std::size_t N>
+auto cards_of(const char* cards) -> card_set {
+    return card_set{debug::make_cards<N>(cards)};
+}
+
+auto deuce_to_seven(const char* cards) -> deuce_to_seven_rank {
+    return evaluate_deuce_to_seven_rank(cards_of<5>(cards));
+}
+
+auto ace_to_five(const char* cards) -> ace_to_five_rank {
+    return evaluate_ace_to_five_rank(cards_of<5>(cards));
+}
+
+// Written against the rank interface only, so it works for any game.
+template<class Rules>
+auto best_of(span<const card_set> hands) -> std::size_t {
+    auto best = std::size_t{0};
+    for (auto i = std::size_t{1}; i < hands.size(); ++i) {
+        if (evaluate_rank<Rules>(hands[i]) > evaluate_rank<Rules>(hands[best])) best = i;
+    }
+    return best;
+}
+
+} // namespace
+
+TEST_CASE("Deuce-to-seven lowball") {
+    const auto best = deuce_to_seven("7c 5d 4h 3s 2c");
+    REQUIRE_GT(best, deuce_to_seven("7c 6d 4h 3s 2c"));
+    REQUIRE_GT(deuce_to_seven("8c 6d 4h 3s 2c"), deuce_to_seven("8c 6d 5h 3s 2c"));
+    // Straights and flushes count, and the ace is high.
+    REQUIRE_GT(deuce_to_seven("Kc Qd Jh Ts 8c"), deuce_to_seven("6c 5d 4h 3s 2c"));
+    REQUIRE_GT(deuce_to_seven("Kc Qd Jh Ts 8c"), deuce_to_seven("7c 5c 4c 3c 2c"));
+    REQUIRE_LT(deuce_to_seven("Ac 5d 4h 3s 2c"), deuce_to_seven("Kc Qd Jh Ts 8c"));
+    REQUIRE_EQ(deuce_to_seven("Ac 5d 4h 3s 2c").ranking(), hand_ranking::high_card);
+    REQUIRE_EQ(deuce_to_seven("6c 5d 4h 3s 2c").ranking(), hand_ranking::straight);
+    // Any pair loses to any high card.
+    REQUIRE_LT(deuce_to_seven("2c 2d 3h 4s 5c"), deuce_to_seven("Ac Kd Qh Js 9c"));
+}
+
+TEST_CASE("Ace-to-five lowball") {
+    const auto wheel = ace_to_five("Ac 2d 3h 4s 5c");
+    REQUIRE_EQ(wheel, ace_to_five("Ac 2c 3c 4c 5c"));
+    REQUIRE_GT(wheel, ace_to_five("Ac 2d 3h 4s 6c"));
+    REQUIRE_GT(ace_to_five("Kc Qd Jh Ts 9c"), ace_to_five("Ac Ad 2h 3s 4c"));
+    REQUIRE_GT(ace_to_five("Ac Ad 2h 3s 4c"), ace_to_five("2c 2d 3h 4s 5c"));
+    REQUIRE_EQ(ace_to_five("Kc Qd Jh Ts 9c").ranking(), hand_ranking::high_card);
+
+    SUBCASE("the lowest five of six or seven cards play") {
+        auto g = std::mt19937{25};
+        for (auto i = 0; i < 3000; ++i) {
+            auto d = deck{g};
+            auto cards = card_set{};
+            for (auto j = 0; j < 7; ++j) cards.insert(d.draw());
+            auto best_of_six = ace_to_five_rank{};
+            for (auto c : cards) {
+                const auto six = cards - card_set{{&c, 1}};
+                auto best_of_five = ace_to_five_rank{};
+                for (auto e : six) best_of_five = std::max(best_of_five, evaluate_ace_to_five_rank(six - card_set{{&e, 1}}));
+                REQUIRE_EQ(evaluate_ace_to_five_rank(six), best_of_five);
+                best_of_six = std::max(best_of_six, best_of_five);
+            }
+            REQUIRE_EQ(evaluate_ace_to_five_rank(cards), best_of_six);
+        }
+    }
+}
+
+TEST_CASE("Showdown code can switch games through the rules") {
+    const card_set hands[] = {
+        cards_of<5>("Ac Kd Qh Js 9c"),
+        cards_of<5>("7c 5d 4h 3s 2c"),
+        cards_of<5>("Ad 2d 3h 4s 5d"),
+    };
+    REQUIRE_EQ(best_of<standard_rules>(hands), 2);
+    REQUIRE_EQ(best_of<deuce_to_seven_rules>(hands), 1);
+    REQUIRE_EQ(best_of<ace_to_five_rules>(hands), 2);
+}
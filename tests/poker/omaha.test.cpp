@@ -0,0 +1,56 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <poker/deck.hpp>
+#include <poker/omaha.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+auto brute_force(span<const card> hole, span<const card> board) -> hand_rank {
+    auto best = hand_rank{};
+    for (auto i = std::size_t{0}; i < hole.size(); ++i)
+    for (auto j = i + 1; j < hole.size(); ++j)
+    for (auto k = std::size_t{0}; k < board.size(); ++k)
+    for (auto l = k + 1; l < board.size(); ++l)
+    for (auto m = l + 1; m < board.size(); ++m) {
+        const auto cards = std::array<card, 5>{hole[i], hole[j], board[k], board[l], board[m]};
+        best = std::max(best, evaluate_rank(cards));
+    }
+    return best;
+}
+
+} // namespace
+
+TEST_CASE("Omaha hands use exactly two hole cards") {
+    // Four hearts on the board and one in the hand is not a flush.
+    const auto board = debug::make_cards<5>("2h 7h 9h Jh Kc");
+    REQUIRE_EQ(evaluate_omaha_rank(debug::make_cards<4>("Ah 3c 4d 5s"), board).ranking(), hand_ranking::high_card);
+    REQUIRE_EQ(evaluate_omaha_rank(debug::make_cards<4>("Ah 3h 4d 5s"), board).ranking(), hand_ranking::flush);
+    // Quads on the board play as trips.
+    const auto quads = debug::make_cards<5>("Ac Ad Ah As Kc");
+    REQUIRE_EQ(evaluate_omaha_rank(debug::make_cards<4>("2c 3d 4h 7s"), quads).ranking(), hand_ranking::three_of_a_kind);
+}
+
+TEST_CASE("Omaha evaluation matches trying every combination") {
+    auto g = std::mt19937{4};
+    for (auto i = 0; i < 5000; ++i) {
+        auto d = deck{g};
+        auto hole = std::array<card, 5>{};
+        auto board = std::array<card, 5>{};
+        for (auto& c : hole) c = d.draw();
+        for (auto& c : board) c = d.draw();
+        for (auto num_hole = std::size_t{4}; num_hole <= 5; ++num_hole) {
+            for (auto num_board = std::size_t{3}; num_board <= 5; ++num_board) {
+                const auto h = span<const card>{hole.data(), num_hole};
+                const auto b = span<const card>{board.data(), num_board};
+                REQUIRE_EQ(evaluate_omaha_rank(h, b), brute_force(h, b));
+            }
+        }
+    }
+}
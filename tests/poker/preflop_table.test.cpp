@@ -0,0 +1,64 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+#include <poker/preflop_table.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+namespace {
+
+// Depends on the ranks and on which cards share a suit, like equity does.
+auto fake_equity(const hole_cards& first, const hole_cards& second) -> double {
+    const auto strength = [] (const hole_cards& hc) {
+        return static_cast<int>(hc.first.rank) + static_cast<int>(hc.second.rank) + 2 + 10 * (hc.first.suit == hc.second.suit);
+    };
+    const auto shared = (first.first.suit == second.first.suit) + (first.second.suit == second.second.suit);
+    return (strength(first) + shared) / static_cast<double>(strength(first) + strength(second) + 2 * shared);
+}
+
+} // namespace
+
+TEST_CASE("Preflop equity table") {
+    auto num_calls = std::atomic<int>{0};
+    const auto table = preflop_equity_table::build([&] (const hole_cards& first, const hole_cards& second) {
+        ++num_calls;
+        return 0.25 + fake_equity(first, second) / 2;
+    }, 2);
+    // Every matchup is played out once up to suits.
+    REQUIRE_EQ(num_calls.load(), 47008);
+    // Relabelling the suits and swapping the hands is handled by the table.
+    const auto aa = debug::make_hole_cards("Ah As");
+    const auto kk = debug::make_hole_cards("Kh Ks");
+    const auto expected = table.equity(aa, kk);
+    REQUIRE_EQ(table.equity(debug::make_hole_cards("Ad Ac"), debug::make_hole_cards("Kd Kc")), expected);
+    REQUIRE_EQ(table.equity(debug::make_hole_cards("Ac Ah"), debug::make_hole_cards("Kh Kc")), expected);
+    REQUIRE(table.equity(kk, aa) == doctest::Approx(1 - expected));
+    REQUIRE_NE(table.equity(debug::make_hole_cards("Ah Ad"), kk), expected);
+
+    SUBCASE("it survives a round trip through a file") {
+        const auto path = "preflop_table.test.bin";
+        REQUIRE(table.save(path));
+        const auto loaded = preflop_equity_table::load(path);
+        REQUIRE(loaded.has_value());
+        for (auto i = std::size_t{0}; i < num_combos; i += 7) {
+            for (auto j = std::size_t{0}; j < num_combos; j += 11) {
+                if (!(combo_set(i) & combo_set(j)).empty()) continue;
+                REQUIRE_EQ(loaded->equity(combo_cards(i), combo_cards(j)), table.equity(combo_cards(i), combo_cards(j)));
+            }
+        }
+        std::remove(path);
+    }
+    SUBCASE("anything else is rejected") {
+        const auto path = "preflop_table.test.bin";
+        {
+            auto out = std::ofstream{path, std::ios::binary};
+            out << "not a preflop table";
+        }
+        REQUIRE_FALSE(preflop_equity_table::load(path).has_value());
+        std::remove(path);
+    }
+}
@@ -0,0 +1,68 @@
+#include <doctest/doctest.h>
+
+#include <random>
+
+#include <poker/hand_rank.hpp>
+#include <poker/short_deck.hpp>
+#include <poker/debug/card.hpp>
+
+using namespace poker;
+
+TEST_CASE("The short deck holds the 36 cards from the sixes up") {
+    auto g = std::mt19937{6};
+    auto d = short_deck::deck{g};
+    REQUIRE_EQ(d.size(), 36);
+    auto dealt = card_set{};
+    while (d.size() != 0) {
+        const auto c = d.draw();
+        REQUIRE_GE(c.rank, card_rank::_6);
+        REQUIRE_FALSE(dealt.contains(c));
+        dealt.insert(c);
+    }
+    REQUIRE_EQ(dealt.size(), 36);
+}
+
+TEST_CASE("Short-deck hand rankings") {
+    const auto rank_of = [] (const char* cards) {
+        return short_deck::evaluate_rank(debug::make_cards<7>(cards));
+    };
+    SUBCASE("A-6-7-8-9 is the lowest straight") {
+        const auto wheel = rank_of("Ac 6d 7h 8s 9c Jd Qh");
+        REQUIRE_EQ(wheel.ranking(), hand_ranking::straight);
+        REQUIRE_LT(wheel, rank_of("6c 7d 8h 9s Tc Kd Qh"));
+        REQUIRE_GT(wheel, rank_of("Ac Ad Ah 8s 9c Jd Qh"));
+        REQUIRE_EQ(rank_of("Ac 6c 7c 8c 9c Jd Qh").ranking(), hand_ranking::straight_flush);
+    }
+    SUBCASE("a flush beats a full house") {
+        const auto flush = rank_of("6c 7c 8c Tc Qc Jd Kh");
+        const auto full_house = rank_of("Ac Ad Ah Ks Kc Jd Qh");
+        REQUIRE_EQ(flush.ranking(), hand_ranking::flush);
+        REQUIRE_EQ(full_house.ranking(), hand_ranking::full_house);
+        REQUIRE_GT(flush, full_house);
+        REQUIRE_LT(flush, rank_of("Ac Ad Ah As Kc Jd Qh"));
+    }
+}
+
+TEST_CASE("Short-deck ranks order hands the way standard ranks do otherwise") {
+    auto g = std::mt19937{36};
+    auto previous = short_deck::hand_rank{};
+    auto previous_standard = hand_rank{};
+    for (auto i = 0; i < 5000; ++i) {
+        auto d = short_deck::deck{g};
+        auto cards = card_set{};
+        for (auto j = 0; j < 7; ++j) cards.insert(d.draw());
+        if ((cards.rank_mask() & 0x10f0) == 0x10f0) continue; // A-6-7-8-9
+        const auto rank = short_deck::evaluate_rank(cards);
+        const auto standard = evaluate_rank(cards);
+        REQUIRE_EQ(rank.ranking(), standard.ranking());
+        const auto swapped = [] (hand_ranking x, hand_ranking y) {
+            return (x == hand_ranking::flush && y == hand_ranking::full_house)
+                || (x == hand_ranking::full_house && y == hand_ranking::flush);
+        };
+        if (!swapped(rank.ranking(), previous.ranking()) && previous != short_deck::hand_rank{}) {
+            REQUIRE_EQ(rank < previous, standard < previous_standard);
+        }
+        previous = rank;
+        previous_standard = standard;
+    }
+}
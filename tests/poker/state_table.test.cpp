@@ -0,0 +1,53 @@
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include <poker/deck.hpp>
+#include <poker/state_table.hpp>
+
+using namespace poker;
+
+TEST_CASE("Advancing a state one card at a time matches evaluate_rank") {
+    const auto table = state_table{};
+    auto g = std::mt19937{11};
+    for (auto i = 0; i < 10000; ++i) {
+        auto d = deck{g};
+        auto state = table.start();
+        for (auto j = 0; j < 7; ++j) state = table.advance(state, d.draw());
+        REQUIRE_EQ(state.cards().size(), 7);
+        REQUIRE_EQ(table.rank(state), evaluate_rank(state.cards()));
+    }
+}
+
+TEST_CASE("A state table survives a round trip through a file") {
+    const auto path = "state_table.test.bin";
+    const auto table = state_table{};
+    REQUIRE(table.save(path));
+    const auto loaded = state_table::load(path);
+    REQUIRE(loaded.has_value());
+    auto g = std::mt19937{13};
+    for (auto i = 0; i < 1000; ++i) {
+        auto d = deck{g};
+        auto state = table.start();
+        auto loaded_state = loaded->start();
+        for (auto j = 0; j < 7; ++j) {
+            const auto c = d.draw();
+            state = table.advance(state, c);
+            loaded_state = loaded->advance(loaded_state, c);
+        }
+        REQUIRE_EQ(loaded->rank(loaded_state), table.rank(state));
+    }
+    std::remove(path);
+
+    SUBCASE("anything else is rejected") {
+        REQUIRE_FALSE(state_table::load("does-not-exist.bin").has_value());
+        {
+            auto out = std::ofstream{path, std::ios::binary};
+            out << "not a state table";
+        }
+        REQUIRE_FALSE(state_table::load(path).has_value());
+        std::remove(path);
+    }
+}
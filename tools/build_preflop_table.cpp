@@ -0,0 +1,38 @@
+// Builds the preflop equity table offline and saves it for
+// preflop_equity_table::load() to map.
+//
+// Usage: poker-preflop-table <path> [num threads]
+//
+// Plays out every heads-up matchup, up to suits, on all of the boards, which
+// takes on the order of an hour of CPU time spread over the threads (all of
+// the hardware threads by default). Exits with 1 if the table cannot be saved.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <poker/preflop_table.hpp>
+#include "poker/detail/parallel.hpp"
+
+using namespace poker;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <path> [num threads]\n", argv[0]);
+        return 1;
+    }
+    const auto path = argv[1];
+    const auto num_threads = detail::resolve_num_threads(argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0);
+
+    std::printf("Building the preflop equity table on %u threads\n", num_threads);
+    std::fflush(stdout);
+    const auto start = std::chrono::steady_clock::now();
+    const auto table = preflop_equity_table::build(num_threads);
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!table.save(path)) {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return 1;
+    }
+    std::printf("Saved %s in %.0f s\n", path, seconds);
+    return 0;
+}
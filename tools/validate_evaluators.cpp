@@ -0,0 +1,183 @@
+// Checks every hand evaluator against the reference evaluation of hand on
+// all C(52, 7) seven-card hands.
+//
+// Usage: poker-validate [num threads]
+//
+// The hands are numbered by card_combinations, so the sweep is cut into
+// ranges of numbers that the threads unrank and walk on their own.
+// Every evaluator must give each hand the very rank the reference gives it,
+// which makes them order all hands exactly like it. Reports the number of
+// hands of each ranking, which must match the known frequencies, and the time
+// each evaluator took. Exits with 1 if anything is off.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <poker/batch_evaluator.hpp>
+#include <poker/card_set.hpp>
+#include <poker/combinations.hpp>
+#include <poker/hand.hpp>
+#include <poker/hand_rank.hpp>
+#include <poker/hand_ranking.hpp>
+#include <poker/state_table.hpp>
+#include "poker/detail/parallel.hpp"
+
+using namespace poker;
+
+namespace {
+
+const auto all_hands = card_combinations{card_set::full(), 7};
+const auto num_hands = all_hands.size();
+constexpr auto num_tasks = std::uint64_t{512};
+constexpr auto block_size = std::size_t{4096};
+
+auto to_cards(card_set cs) -> std::array<card, 7> {
+    auto result = std::array<card, 7>{};
+    std::copy(cs.begin(), cs.end(), result.begin());
+    return result;
+}
+
+auto reference_rank(card_set cs) -> hand_rank {
+    auto cards = to_cards(cs);
+    auto h = hand::_high_low_hand_eval(cards);
+    if (auto flush = hand::_straight_flush_eval(cards)) h = std::max(h, *flush);
+    return h.rank();
+}
+
+struct backend {
+    const char* name;
+    void (*evaluate)(const card_set* in, hand_rank* out, std::size_t n);
+};
+
+const auto backends = [] {
+    auto result = std::vector<backend>{
+        {"hand", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            for (auto i = std::size_t{0}; i < n; ++i) {
+                auto cards = to_cards(in[i]);
+                out[i] = hand{span<card, 7>{cards}}.rank();
+            }
+        }},
+        {"evaluate_rank", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            for (auto i = std::size_t{0}; i < n; ++i) out[i] = evaluate_rank(in[i]);
+        }},
+        {"evaluate_batch", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            evaluate_batch({in, n}, {out, n});
+        }},
+        {"evaluate_batch (scalar)", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            detail::evaluate_batch_scalar(in, out, n);
+        }},
+        {"state_table", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            static const auto table = state_table{};
+            for (auto i = std::size_t{0}; i < n; ++i) {
+                auto state = table.start();
+                for (auto c : in[i]) state = table.advance(state, c);
+                out[i] = table.rank(state);
+            }
+        }},
+    };
+#if POKER_DETAIL_HAS_AVX2_KERNEL
+    if (detail::cpu_supports_avx2()) {
+        result.push_back({"evaluate_batch (avx2)", [] (const card_set* in, hand_rank* out, std::size_t n) {
+            detail::evaluate_batch_avx2(in, out, n);
+        }});
+    }
+#endif
+    return result;
+}();
+
+constexpr const char* ranking_names[] = {
+    "high card", "pair", "two pair", "three of a kind", "straight",
+    "flush", "full house", "four of a kind", "straight flush", "royal flush",
+};
+
+constexpr std::uint64_t expected_counts[] = {
+    23294460, 58627800, 31433400, 6461620, 6180020, 4047644, 3473184, 224848, 37260, 4324,
+};
+
+// What one worker found, a cache line apart from the others.
+struct alignas(64) worker_results {
+    std::array<std::uint64_t, 10> counts = {};
+    std::vector<std::uint64_t> mismatches = std::vector<std::uint64_t>(backends.size());
+    std::vector<double> seconds = std::vector<double>(backends.size() + 1);
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using clock_type = std::chrono::steady_clock;
+    const auto num_threads = detail::resolve_num_threads(argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 0);
+    auto results = std::vector<worker_results>(num_threads);
+    auto report_mutex = std::mutex{};
+    auto num_reported = 0;
+
+    std::printf("Checking %zu evaluators on %llu hands on %u threads\n", backends.size(),
+                static_cast<unsigned long long>(num_hands), num_threads);
+    const auto start = clock_type::now();
+    detail::parallel_for(num_tasks, num_threads, [&] (std::size_t task, unsigned worker) {
+        auto& r = results[worker];
+        auto hands = std::array<card_set, block_size>{};
+        auto expected = std::array<hand_rank, block_size>{};
+        auto ranks = std::array<hand_rank, block_size>{};
+        const auto [begin, end] = all_hands.range(task, num_tasks);
+        for (auto first = begin; first < end; first += block_size) {
+            const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(block_size, end - first));
+            auto num_filled = std::size_t{0};
+            all_hands.for_each(first, first + n, [&] (card_set cs) { hands[num_filled++] = cs; });
+            auto t = clock_type::now();
+            for (auto i = std::size_t{0}; i < n; ++i) {
+                expected[i] = reference_rank(hands[i]);
+                ++r.counts[static_cast<int>(expected[i].ranking())];
+            }
+            r.seconds.back() += std::chrono::duration<double>(clock_type::now() - t).count();
+            for (auto b = std::size_t{0}; b < backends.size(); ++b) {
+                t = clock_type::now();
+                backends[b].evaluate(hands.data(), ranks.data(), n);
+                r.seconds[b] += std::chrono::duration<double>(clock_type::now() - t).count();
+                for (auto i = std::size_t{0}; i < n; ++i) {
+                    if (ranks[i] == expected[i]) continue;
+                    ++r.mismatches[b];
+                    const auto lock = std::lock_guard{report_mutex};
+                    if (num_reported++ >= 20) continue;
+                    std::printf("MISMATCH %s on hand %llu (cards", backends[b].name, static_cast<unsigned long long>(first + i));
+                    for (auto card : hands[i]) std::printf(" %d", static_cast<int>(to_card_index(card)));
+                    std::printf("): %d, expected %d\n", ranks[i].value(), expected[i].value());
+                }
+            }
+        }
+    });
+    const auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    auto ok = true;
+    std::printf("\n%-16s %12s %12s\n", "ranking", "hands", "expected");
+    for (auto k = 0; k < 10; ++k) {
+        auto count = std::uint64_t{0};
+        for (const auto& r : results) count += r.counts[k];
+        ok = ok && count == expected_counts[k];
+        std::printf("%-16s %12llu %12llu%s\n", ranking_names[k], static_cast<unsigned long long>(count),
+                    static_cast<unsigned long long>(expected_counts[k]), count == expected_counts[k] ? "" : "  WRONG");
+    }
+
+    std::printf("\n%-24s %12s %10s %14s\n", "evaluator", "mismatches", "ns/hand", "hands/s");
+    for (auto b = std::size_t{0}; b <= backends.size(); ++b) {
+        auto mismatches = std::uint64_t{0};
+        auto cpu_seconds = 0.0;
+        for (const auto& r : results) {
+            if (b < backends.size()) mismatches += r.mismatches[b];
+            cpu_seconds += r.seconds[b];
+        }
+        ok = ok && mismatches == 0;
+        // Throughput as if the evaluator had the threads to itself.
+        std::printf("%-24s %12llu %10.2f %14.4g\n", b < backends.size() ? backends[b].name : "reference",
+                    static_cast<unsigned long long>(mismatches), cpu_seconds * 1e9 / num_hands, num_hands * num_threads / cpu_seconds);
+    }
+    std::printf("\n%s in %.1f s\n", ok ? "OK" : "FAILED", seconds);
+    return ok ? 0 : 1;
+}